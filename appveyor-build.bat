@@ -116,12 +116,18 @@ IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 
 SET PATH=%PROJECT_DIR%\osrm-deps\libs\bin;%PATH%
 
+ECHO running contractor-tests.exe ...
+%Configuration%\unit_tests\contractor-tests.exe
+IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 ECHO running engine-tests.exe ...
 %Configuration%\unit_tests\engine-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 ECHO running extractor-tests.exe ...
 %Configuration%\unit_tests\extractor-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
+ECHO running storage-tests.exe ...
+%Configuration%\unit_tests\storage-tests.exe
+IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 ECHO running util-tests.exe ...
 %Configuration%\unit_tests\util-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
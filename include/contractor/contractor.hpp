@@ -65,19 +65,26 @@ class Contractor
                        std::vector<EdgeWeight> &&node_weights,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
+    void RecontractCore(const unsigned max_edge_id,
+                        util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                        util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                        std::vector<EdgeWeight> &&node_weights,
+                        std::vector<bool> &is_core_node,
+                        std::vector<float> &out_node_levels) const;
+    unsigned ResumeContractGraph(util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                                 std::vector<bool> &is_core_node,
+                                 std::vector<float> &out_node_levels,
+                                 bool &out_computed_node_levels) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
+    void ReadCoreNodeMarker(std::vector<bool> &is_core_node) const;
     std::size_t
     WriteContractedGraph(unsigned number_of_edge_based_nodes,
                          const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
     void FindComponents(unsigned max_edge_id,
                         const util::DeallocatingVector<extractor::EdgeBasedEdge> &edges,
                         std::vector<extractor::EdgeBasedNode> &nodes) const;
-
-  private:
-    ContractorConfig config;
-
     std::size_t
     LoadEdgeExpandedGraph(const std::string &edge_based_graph_path,
                           util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
@@ -89,6 +96,9 @@ class Contractor
                           const std::string &datasource_names_filename,
                           const std::string &datasource_indexes_filename,
                           const std::string &rtree_leaf_filename);
+
+  private:
+    ContractorConfig config;
 };
 }
 }
@@ -39,13 +39,18 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig()
+        : use_nested_dissection(false), update_core_only(false), core_update_radius(2),
+          requested_num_threads(0), checkpoint_interval(0), resume_from_checkpoint(false)
+    {
+    }
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
     {
         level_output_path = osrm_input_path.string() + ".level";
         core_output_path = osrm_input_path.string() + ".core";
+        checkpoint_path = osrm_input_path.string() + ".checkpoint";
         graph_output_path = osrm_input_path.string() + ".hsgr";
         edge_based_graph_path = osrm_input_path.string() + ".ebg";
         edge_segment_lookup_path = osrm_input_path.string() + ".edge_segment_lookup";
@@ -71,6 +76,15 @@ struct ContractorConfig
     std::string geometry_path;
     std::string rtree_leaf_path;
     bool use_cached_priority;
+    // Derive the contraction order from a nested dissection of the graph instead of the
+    // edge-difference priority. The order is written to the .level file.
+    bool use_nested_dissection;
+
+    // Reuse the hierarchy of the previous .hsgr/.level and only recontract the nodes whose
+    // edge weights changed, their neighbourhood of core_update_radius hops and everything
+    // above them in the hierarchy.
+    bool update_core_only;
+    unsigned core_update_radius;
 
     unsigned requested_num_threads;
 
@@ -80,6 +94,15 @@ struct ContractorConfig
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
 
+    // Minutes between two checkpoints of the contraction state, 0 disables checkpointing.
+    unsigned checkpoint_interval;
+    // Continue an interrupted contraction from the last checkpoint instead of starting over
+    bool resume_from_checkpoint;
+    std::string checkpoint_path;
+
+    // If set, per-round contraction statistics are written to this file as JSON lines
+    std::string round_statistics_path;
+
     std::vector<std::string> segment_speed_lookup_paths;
     std::string datasource_indexes_path;
     std::string datasource_names_path;
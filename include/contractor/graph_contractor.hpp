@@ -4,7 +4,12 @@
 #include "util/binary_heap.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/dynamic_graph.hpp"
+#include "util/exception.hpp"
+#include "util/io.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
 #include "util/percent.hpp"
+#include "util/process_memory.hpp"
 #include "contractor/query_edge.hpp"
 #include "util/xor_fast_hash.hpp"
 #include "util/xor_fast_hash_storage.hpp"
@@ -14,6 +19,8 @@
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include <stxxl/vector>
 
@@ -22,8 +29,11 @@
 #include <tbb/parallel_sort.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -86,6 +96,9 @@ class GraphContractor
         ContractorHeap heap;
         std::vector<ContractorEdge> inserted_edges;
         std::vector<NodeID> neighbours;
+        // nodes settled by witness searches since the last round, used for statistics only
+        std::uint64_t witness_settled_nodes = 0;
+        std::uint64_t simulation_settled_nodes = 0;
         explicit ContractorThreadData(NodeID nodes) : heap(nodes) {}
     };
 
@@ -133,6 +146,19 @@ class GraphContractor
         EnumerableThreadData data;
     };
 
+    // State of Run() between two contraction rounds, as restored from a checkpoint file
+    struct CheckpointState
+    {
+        NodeID number_of_nodes = 0;
+        NodeID number_of_contracted_nodes = 0;
+        unsigned current_level = 0;
+        bool flushed_contractor = false;
+        bool use_cached_node_priorities = false;
+        std::vector<RemainingNodeData> remaining_nodes;
+        std::vector<float> node_priorities;
+        std::vector<NodeDepth> node_depth;
+    };
+
   public:
     template <class ContainerT>
     GraphContractor(int nodes, ContainerT &input_edge_list)
@@ -250,6 +276,37 @@ class GraphContractor
         util::SimpleLogger().Write() << "contractor finished initalization";
     }
 
+    // Restores a partially contracted graph from a checkpoint written by a previous Run().
+    // Calling Run() afterwards continues with the next contraction round.
+    explicit GraphContractor(const std::string &checkpoint_path)
+    {
+        ReadCheckpoint(checkpoint_path);
+    }
+
+    // Periodically write the contraction state to checkpoint_path, at most every
+    // interval_in_minutes minutes. Checkpoints are only taken between two rounds.
+    void EnableCheckpoints(const std::string &checkpoint_path_, const unsigned interval_in_minutes)
+    {
+        checkpoint_path = checkpoint_path_;
+        checkpoint_interval = std::chrono::minutes(interval_in_minutes);
+    }
+
+    // Write one JSON object per contraction round to statistics_path, with the size of the
+    // independent set, the number of shortcuts, witness search effort, graph density, the
+    // time spent in each phase and the resident memory of the process.
+    void EnableRoundStatistics(const std::string &statistics_path)
+    {
+        round_statistics_path = statistics_path;
+    }
+
+    // Number of nodes of the input graph. Only valid before Run(), which renumbers the nodes
+    // when flushing the contracted part of the graph.
+    NodeID GetNumberOfInputNodes() const
+    {
+        return resume_state ? resume_state->number_of_nodes
+                            : static_cast<NodeID>(contractor_graph->GetNumberOfNodes());
+    }
+
     void Run(double core_factor = 1.0)
     {
         // for the preperation we can use a big grain size, which is much faster (probably cache)
@@ -263,63 +320,103 @@ class GraphContractor
         const constexpr size_t NeighboursGrainSize = 1;
         const constexpr size_t DeleteGrainSize = 1;
 
-        const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
+        const NodeID number_of_nodes = GetNumberOfInputNodes();
         util::Percent p(number_of_nodes);
 
-        ThreadDataContainer thread_data_list(number_of_nodes);
+        ThreadDataContainer thread_data_list(contractor_graph->GetNumberOfNodes());
 
         NodeID number_of_contracted_nodes = 0;
         std::vector<NodeDepth> node_depth;
         std::vector<float> node_priorities;
         is_core_node.resize(number_of_nodes, false);
 
-        std::vector<RemainingNodeData> remaining_nodes(number_of_nodes);
-        // initialize priorities in parallel
-        tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, InitGrainSize),
-                          [this, &remaining_nodes](const tbb::blocked_range<int> &range)
-                          {
-                              for (int x = range.begin(), end = range.end(); x != end; ++x)
-                              {
-                                  remaining_nodes[x].id = x;
-                              }
-                          });
+        std::vector<RemainingNodeData> remaining_nodes;
+        unsigned current_level = 0;
+        bool flushed_contractor = false;
+        bool use_cached_node_priorities = false;
+        const bool resumed = resume_state != nullptr;
 
-        bool use_cached_node_priorities = !node_levels.empty();
-        if (use_cached_node_priorities)
+        if (resumed)
         {
-            std::cout << "using cached node priorities ..." << std::flush;
-            node_priorities.swap(node_levels);
-            std::cout << "ok" << std::endl;
+            util::SimpleLogger().Write() << "resuming contraction at level "
+                                         << resume_state->current_level << " with "
+                                         << resume_state->number_of_contracted_nodes << " of "
+                                         << number_of_nodes << " nodes contracted";
+            number_of_contracted_nodes = resume_state->number_of_contracted_nodes;
+            current_level = resume_state->current_level;
+            flushed_contractor = resume_state->flushed_contractor;
+            use_cached_node_priorities = resume_state->use_cached_node_priorities;
+            remaining_nodes.swap(resume_state->remaining_nodes);
+            node_priorities.swap(resume_state->node_priorities);
+            node_depth.swap(resume_state->node_depth);
+            resume_state.reset();
         }
         else
         {
-            node_depth.resize(number_of_nodes, 0);
-            node_priorities.resize(number_of_nodes);
-            node_levels.resize(number_of_nodes);
-
-            std::cout << "initializing elimination PQ ..." << std::flush;
-            tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, PQGrainSize),
-                              [this, &node_priorities, &node_depth,
-                               &thread_data_list](const tbb::blocked_range<int> &range)
+            remaining_nodes.resize(number_of_nodes);
+            // initialize priorities in parallel
+            tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, InitGrainSize),
+                              [this, &remaining_nodes](const tbb::blocked_range<int> &range)
                               {
-                                  ContractorThreadData *data = thread_data_list.getThreadData();
                                   for (int x = range.begin(), end = range.end(); x != end; ++x)
                                   {
-                                      node_priorities[x] =
-                                          this->EvaluateNodePriority(data, node_depth[x], x);
+                                      remaining_nodes[x].id = x;
                                   }
                               });
-            std::cout << "ok" << std::endl;
+
+            use_cached_node_priorities = !node_levels.empty();
+            if (use_cached_node_priorities)
+            {
+                std::cout << "using cached node priorities ..." << std::flush;
+                node_priorities.swap(node_levels);
+                std::cout << "ok" << std::endl;
+            }
+            else
+            {
+                node_depth.resize(number_of_nodes, 0);
+                node_priorities.resize(number_of_nodes);
+                node_levels.resize(number_of_nodes);
+
+                std::cout << "initializing elimination PQ ..." << std::flush;
+                tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, PQGrainSize),
+                                  [this, &node_priorities, &node_depth,
+                                   &thread_data_list](const tbb::blocked_range<int> &range)
+                                  {
+                                      ContractorThreadData *data =
+                                          thread_data_list.getThreadData();
+                                      for (int x = range.begin(), end = range.end(); x != end;
+                                           ++x)
+                                      {
+                                          node_priorities[x] =
+                                              this->EvaluateNodePriority(data, node_depth[x], x);
+                                      }
+                                  });
+                std::cout << "ok" << std::endl;
+            }
         }
-        BOOST_ASSERT(node_priorities.size() == number_of_nodes);
+        BOOST_ASSERT(node_priorities.size() == contractor_graph->GetNumberOfNodes());
+        used_cached_node_levels = use_cached_node_priorities;
 
         std::cout << "preprocessing " << number_of_nodes << " nodes ..." << std::flush;
 
-        unsigned current_level = 0;
-        bool flushed_contractor = false;
+        boost::filesystem::ofstream round_statistics_stream;
+        if (!round_statistics_path.empty())
+        {
+            // a resumed run continues the statistics of the interrupted one
+            round_statistics_stream.open(round_statistics_path,
+                                         resumed ? std::ios::app : std::ios::out);
+            if (!round_statistics_stream)
+            {
+                throw util::exception("Failed to open " + round_statistics_path + " for writing");
+            }
+        }
+
+        auto last_checkpoint = std::chrono::steady_clock::now();
         while (number_of_nodes > 2 &&
                number_of_contracted_nodes < static_cast<NodeID>(number_of_nodes * core_factor))
         {
+            TIMER_START(flush);
+            const bool flushed_before_round = flushed_contractor;
             if (!flushed_contractor && (number_of_contracted_nodes >
                                         static_cast<NodeID>(number_of_nodes * 0.65 * core_factor)))
             {
@@ -418,7 +515,9 @@ class GraphContractor
                 // reinitialize heaps and ThreadData objects with appropriate size
                 thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
             }
+            TIMER_STOP(flush);
 
+            TIMER_START(independent_set);
             tbb::parallel_for(
                 tbb::blocked_range<std::size_t>(0, remaining_nodes.size(), IndependentGrainSize),
                 [this, &node_priorities, &remaining_nodes,
@@ -443,6 +542,7 @@ class GraphContractor
             auto begin_independent_nodes_idx =
                 std::distance(remaining_nodes.begin(), begin_independent_nodes);
             auto end_independent_nodes_idx = remaining_nodes.size();
+            TIMER_STOP(independent_set);
 
             if (!use_cached_node_priorities)
             {
@@ -475,6 +575,7 @@ class GraphContractor
             }
 
             // contract independent nodes
+            TIMER_START(contraction);
             tbb::parallel_for(tbb::blocked_range<std::size_t>(begin_independent_nodes_idx,
                                                               end_independent_nodes_idx,
                                                               ContractGrainSize),
@@ -489,7 +590,9 @@ class GraphContractor
                                       this->ContractNode<false>(data, x);
                                   }
                               });
+            TIMER_STOP(contraction);
 
+            TIMER_START(deletion);
             tbb::parallel_for(
                 tbb::blocked_range<int>(begin_independent_nodes_idx, end_independent_nodes_idx,
                                         DeleteGrainSize),
@@ -503,8 +606,10 @@ class GraphContractor
                         this->DeleteIncomingEdges(data, x);
                     }
                 });
+            TIMER_STOP(deletion);
 
             // make sure we really sort each block
+            TIMER_START(insertion);
             tbb::parallel_for(
                 thread_data_list.data.range(),
                 [&](const ThreadDataContainer::EnumerableThreadData::range_type &range)
@@ -515,8 +620,10 @@ class GraphContractor
                 });
 
             // insert new edges
+            std::uint64_t shortcuts_added = 0;
             for (auto &data : thread_data_list.data)
             {
+                shortcuts_added += data->inserted_edges.size();
                 for (const ContractorEdge &edge : data->inserted_edges)
                 {
                     const EdgeID current_edge_ID =
@@ -538,7 +645,9 @@ class GraphContractor
                 }
                 data->inserted_edges.clear();
             }
+            TIMER_STOP(insertion);
 
+            TIMER_START(neighbour_update);
             if (!use_cached_node_priorities)
             {
                 tbb::parallel_for(
@@ -556,13 +665,75 @@ class GraphContractor
                         }
                     });
             }
+            TIMER_STOP(neighbour_update);
 
             // remove contracted nodes from the pool
             number_of_contracted_nodes += end_independent_nodes_idx - begin_independent_nodes_idx;
             remaining_nodes.resize(begin_independent_nodes_idx);
 
+            if (round_statistics_stream.is_open())
+            {
+                std::uint64_t witness_settled_nodes = 0;
+                std::uint64_t simulation_settled_nodes = 0;
+                for (auto &data : thread_data_list.data)
+                {
+                    witness_settled_nodes += data->witness_settled_nodes;
+                    simulation_settled_nodes += data->simulation_settled_nodes;
+                    data->witness_settled_nodes = 0;
+                    data->simulation_settled_nodes = 0;
+                }
+
+                util::json::Object round;
+                round.values["level"] = current_level;
+                round.values["remaining_nodes"] = remaining_nodes.size();
+                round.values["independent_nodes"] =
+                    end_independent_nodes_idx - begin_independent_nodes_idx;
+                round.values["contracted_nodes"] = number_of_contracted_nodes;
+                round.values["shortcuts_added"] = shortcuts_added;
+                round.values["witness_settled_nodes"] = witness_settled_nodes;
+                round.values["simulation_settled_nodes"] = simulation_settled_nodes;
+                round.values["edges"] = contractor_graph->GetNumberOfEdges();
+                round.values["edges_per_node"] =
+                    remaining_nodes.empty() ? 0.
+                                            : contractor_graph->GetNumberOfEdges() /
+                                                  static_cast<double>(remaining_nodes.size());
+                round.values["flush_ms"] = TIMER_MSEC(flush);
+                round.values["independent_set_ms"] = TIMER_MSEC(independent_set);
+                round.values["contraction_ms"] = TIMER_MSEC(contraction);
+                round.values["deletion_ms"] = TIMER_MSEC(deletion);
+                round.values["insertion_ms"] = TIMER_MSEC(insertion);
+                round.values["priority_update_ms"] = TIMER_MSEC(neighbour_update);
+                round.values["flushed"] = !flushed_before_round && flushed_contractor
+                                              ? util::json::Value(util::json::True())
+                                              : util::json::Value(util::json::False());
+                round.values["rss_bytes"] = util::getResidentSetSize();
+                util::json::render(round_statistics_stream, round);
+                round_statistics_stream << std::endl;
+            }
+
             p.printStatus(number_of_contracted_nodes);
             ++current_level;
+
+            if (!checkpoint_path.empty() &&
+                std::chrono::steady_clock::now() - last_checkpoint >= checkpoint_interval)
+            {
+                CheckpointState state;
+                state.number_of_nodes = number_of_nodes;
+                state.number_of_contracted_nodes = number_of_contracted_nodes;
+                state.current_level = current_level;
+                state.flushed_contractor = flushed_contractor;
+                state.use_cached_node_priorities = use_cached_node_priorities;
+                state.remaining_nodes.swap(remaining_nodes);
+                state.node_priorities.swap(node_priorities);
+                state.node_depth.swap(node_depth);
+
+                WriteCheckpoint(state);
+
+                remaining_nodes.swap(state.remaining_nodes);
+                node_priorities.swap(state.node_priorities);
+                node_depth.swap(state.node_depth);
+                last_checkpoint = std::chrono::steady_clock::now();
+            }
         }
 
         if (remaining_nodes.size() > 2)
@@ -617,6 +788,10 @@ class GraphContractor
         out_node_levels.swap(node_levels);
     }
 
+    // True if Run() contracted in the order of given node levels, which it doesn't hand back.
+    // A resumed Run() follows the levels of the interrupted one.
+    bool UsedCachedNodeLevels() const { return used_cached_node_levels; }
+
     template <class Edge> inline void GetEdges(util::DeallocatingVector<Edge> &edges)
     {
         util::Percent p(contractor_graph->GetNumberOfNodes());
@@ -674,6 +849,182 @@ class GraphContractor
     }
 
   private:
+    template <typename T>
+    static void WriteCheckpointVector(std::ostream &stream, const std::vector<T> &data)
+    {
+        const std::uint64_t count = data.size();
+        stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        if (count > 0)
+        {
+            stream.write(reinterpret_cast<const char *>(data.data()), sizeof(T) * count);
+        }
+    }
+
+    template <typename T>
+    static void ReadCheckpointVector(std::istream &stream, std::vector<T> &data)
+    {
+        std::uint64_t count = 0;
+        stream.read(reinterpret_cast<char *>(&count), sizeof(count));
+        data.resize(count);
+        if (count > 0)
+        {
+            stream.read(reinterpret_cast<char *>(data.data()), sizeof(T) * count);
+        }
+    }
+
+    // Streams the state between two rounds to disk. The file is written next to the final
+    // location and renamed afterwards, so an interrupted write never replaces a valid checkpoint.
+    void WriteCheckpoint(const CheckpointState &state)
+    {
+        TIMER_START(checkpoint);
+        const std::string temporary_path = checkpoint_path + ".tmp";
+        {
+            boost::filesystem::ofstream stream(temporary_path, std::ios::binary);
+            if (!stream)
+            {
+                throw util::exception("Failed to open " + temporary_path + " for writing");
+            }
+
+            util::writeFingerprint(stream);
+
+            const std::uint32_t number_of_nodes = state.number_of_nodes;
+            const std::uint32_t number_of_contracted_nodes = state.number_of_contracted_nodes;
+            const std::uint32_t current_level = state.current_level;
+            const std::uint8_t flushed_contractor = state.flushed_contractor;
+            const std::uint8_t use_cached_node_priorities = state.use_cached_node_priorities;
+            stream.write(reinterpret_cast<const char *>(&number_of_nodes), sizeof(number_of_nodes));
+            stream.write(reinterpret_cast<const char *>(&number_of_contracted_nodes),
+                         sizeof(number_of_contracted_nodes));
+            stream.write(reinterpret_cast<const char *>(&current_level), sizeof(current_level));
+            stream.write(reinterpret_cast<const char *>(&flushed_contractor),
+                         sizeof(flushed_contractor));
+            stream.write(reinterpret_cast<const char *>(&use_cached_node_priorities),
+                         sizeof(use_cached_node_priorities));
+
+            WriteCheckpointVector(stream, state.remaining_nodes);
+            WriteCheckpointVector(stream, state.node_priorities);
+            WriteCheckpointVector(stream, state.node_depth);
+            WriteCheckpointVector(stream, node_levels);
+            WriteCheckpointVector(stream, node_weights);
+            WriteCheckpointVector(stream, orig_node_id_from_new_node_id_map);
+
+            // remaining graph, streamed node by node
+            const std::uint32_t number_of_graph_nodes = contractor_graph->GetNumberOfNodes();
+            std::uint64_t number_of_graph_edges = 0;
+            for (const auto node : util::irange(0u, number_of_graph_nodes))
+            {
+                number_of_graph_edges += contractor_graph->GetOutDegree(node);
+            }
+            stream.write(reinterpret_cast<const char *>(&number_of_graph_nodes),
+                         sizeof(number_of_graph_nodes));
+            stream.write(reinterpret_cast<const char *>(&number_of_graph_edges),
+                         sizeof(number_of_graph_edges));
+            for (const auto node : util::irange(0u, number_of_graph_nodes))
+            {
+                for (auto edge : contractor_graph->GetAdjacentEdgeRange(node))
+                {
+                    const ContractorEdge graph_edge{node, contractor_graph->GetTarget(edge),
+                                                    contractor_graph->GetEdgeData(edge)};
+                    stream.write(reinterpret_cast<const char *>(&graph_edge), sizeof(graph_edge));
+                }
+            }
+
+            // edges of nodes that were contracted before the flush
+            const std::uint64_t number_of_external_edges = external_edge_list.size();
+            stream.write(reinterpret_cast<const char *>(&number_of_external_edges),
+                         sizeof(number_of_external_edges));
+            for (const QueryEdge &edge : external_edge_list)
+            {
+                stream.write(reinterpret_cast<const char *>(&edge), sizeof(edge));
+            }
+
+            if (!stream)
+            {
+                throw util::exception("Failed writing checkpoint to " + temporary_path);
+            }
+        }
+        boost::filesystem::rename(temporary_path, checkpoint_path);
+        TIMER_STOP(checkpoint);
+
+        util::SimpleLogger().Write() << "wrote checkpoint at level " << state.current_level
+                                     << " to " << checkpoint_path << " in " << TIMER_SEC(checkpoint)
+                                     << " sec";
+    }
+
+    void ReadCheckpoint(const std::string &path)
+    {
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream)
+        {
+            throw util::exception("Failed to open checkpoint " + path);
+        }
+        if (!util::readAndCheckFingerprint(stream))
+        {
+            throw util::exception("Checkpoint " + path +
+                                  " was written by an incompatible version of osrm-contract");
+        }
+
+        resume_state = std::unique_ptr<CheckpointState>(new CheckpointState());
+
+        std::uint32_t number_of_nodes = 0;
+        std::uint32_t number_of_contracted_nodes = 0;
+        std::uint32_t current_level = 0;
+        std::uint8_t flushed_contractor = 0;
+        std::uint8_t use_cached_node_priorities = 0;
+        stream.read(reinterpret_cast<char *>(&number_of_nodes), sizeof(number_of_nodes));
+        stream.read(reinterpret_cast<char *>(&number_of_contracted_nodes),
+                    sizeof(number_of_contracted_nodes));
+        stream.read(reinterpret_cast<char *>(&current_level), sizeof(current_level));
+        stream.read(reinterpret_cast<char *>(&flushed_contractor), sizeof(flushed_contractor));
+        stream.read(reinterpret_cast<char *>(&use_cached_node_priorities),
+                    sizeof(use_cached_node_priorities));
+        resume_state->number_of_nodes = number_of_nodes;
+        resume_state->number_of_contracted_nodes = number_of_contracted_nodes;
+        resume_state->current_level = current_level;
+        resume_state->flushed_contractor = flushed_contractor != 0;
+        resume_state->use_cached_node_priorities = use_cached_node_priorities != 0;
+
+        ReadCheckpointVector(stream, resume_state->remaining_nodes);
+        ReadCheckpointVector(stream, resume_state->node_priorities);
+        ReadCheckpointVector(stream, resume_state->node_depth);
+        ReadCheckpointVector(stream, node_levels);
+        ReadCheckpointVector(stream, node_weights);
+        ReadCheckpointVector(stream, orig_node_id_from_new_node_id_map);
+
+        std::uint32_t number_of_graph_nodes = 0;
+        std::uint64_t number_of_graph_edges = 0;
+        stream.read(reinterpret_cast<char *>(&number_of_graph_nodes),
+                    sizeof(number_of_graph_nodes));
+        stream.read(reinterpret_cast<char *>(&number_of_graph_edges),
+                    sizeof(number_of_graph_edges));
+        {
+            std::vector<ContractorEdge> edges(number_of_graph_edges);
+            if (number_of_graph_edges > 0)
+            {
+                stream.read(reinterpret_cast<char *>(edges.data()),
+                            sizeof(ContractorEdge) * number_of_graph_edges);
+            }
+            // edges are grouped by source but not ordered by target
+            tbb::parallel_sort(edges.begin(), edges.end());
+            contractor_graph = std::make_shared<ContractorGraph>(number_of_graph_nodes, edges);
+        }
+
+        std::uint64_t number_of_external_edges = 0;
+        stream.read(reinterpret_cast<char *>(&number_of_external_edges),
+                    sizeof(number_of_external_edges));
+        QueryEdge edge;
+        for (; number_of_external_edges > 0; --number_of_external_edges)
+        {
+            stream.read(reinterpret_cast<char *>(&edge), sizeof(edge));
+            external_edge_list.push_back(edge);
+        }
+
+        if (!stream)
+        {
+            throw util::exception("Checkpoint " + path + " is truncated");
+        }
+    }
+
     inline void RelaxNode(const NodeID node,
                           const NodeID forbidden_node,
                           const int distance,
@@ -708,11 +1059,12 @@ class GraphContractor
         }
     }
 
-    inline void Dijkstra(const int max_distance,
-                         const unsigned number_of_targets,
-                         const int maxNodes,
-                         ContractorThreadData &data,
-                         const NodeID middleNode)
+    // Returns the number of nodes settled by the witness search
+    inline int Dijkstra(const int max_distance,
+                        const unsigned number_of_targets,
+                        const int maxNodes,
+                        ContractorThreadData &data,
+                        const NodeID middleNode)
     {
 
         ContractorHeap &heap = data.heap;
@@ -725,11 +1077,11 @@ class GraphContractor
             const auto distance = heap.GetKey(node);
             if (++nodes > maxNodes)
             {
-                return;
+                return nodes;
             }
             if (distance > max_distance)
             {
-                return;
+                return nodes;
             }
 
             // Destination settled?
@@ -738,12 +1090,13 @@ class GraphContractor
                 ++number_of_targets_found;
                 if (number_of_targets_found >= number_of_targets)
                 {
-                    return;
+                    return nodes;
                 }
             }
 
             RelaxNode(node, middleNode, distance, heap);
         }
+        return nodes;
     }
 
     inline float EvaluateNodePriority(ContractorThreadData *const data,
@@ -867,13 +1220,14 @@ class GraphContractor
             if (RUNSIMULATION)
             {
                 const int constexpr SIMULATION_SEARCH_SPACE_SIZE = 1000;
-                Dijkstra(max_distance, number_of_targets, SIMULATION_SEARCH_SPACE_SIZE, *data,
-                         node);
+                data->simulation_settled_nodes += Dijkstra(
+                    max_distance, number_of_targets, SIMULATION_SEARCH_SPACE_SIZE, *data, node);
             }
             else
             {
                 const int constexpr FULL_SEARCH_SPACE_SIZE = 2000;
-                Dijkstra(max_distance, number_of_targets, FULL_SEARCH_SPACE_SIZE, *data, node);
+                data->witness_settled_nodes +=
+                    Dijkstra(max_distance, number_of_targets, FULL_SEARCH_SPACE_SIZE, *data, node);
             }
             for (auto out_edge : contractor_graph->GetAdjacentEdgeRange(node))
             {
@@ -1098,6 +1452,12 @@ class GraphContractor
     std::vector<EdgeWeight> node_weights;
     std::vector<bool> is_core_node;
     util::XORFastHash<> fast_hash;
+
+    std::string checkpoint_path;
+    std::chrono::minutes checkpoint_interval{0};
+    std::string round_statistics_path;
+    std::unique_ptr<CheckpointState> resume_state;
+    bool used_cached_node_levels = false;
 };
 }
 }
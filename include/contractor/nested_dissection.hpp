@@ -0,0 +1,56 @@
+#ifndef NESTED_DISSECTION_HPP
+#define NESTED_DISSECTION_HPP
+
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Computes a contraction order by recursively bisecting the (undirected) edge-based graph
+// with small vertex separators. Nodes inside the smallest cells are contracted first, the
+// separator of the whole graph last. The result has the same semantics as the .level file
+// and can be passed to the GraphContractor in place of cached node levels.
+//
+// Cells are split along a BFS level structure rooted at a pseudo-peripheral node: the
+// median level becomes the separator, minus the nodes that have no neighbour beyond it.
+class NestedDissection
+{
+  public:
+    NestedDissection(const NodeID number_of_nodes,
+                     const util::DeallocatingVector<extractor::EdgeBasedEdge> &edges);
+
+    // Returns a level for every node: [0, 1) for nodes in leaf cells, larger values for the
+    // separators of larger cells. The fraction orders the nodes of a level by degree.
+    std::vector<float> ComputeNodeLevels();
+
+  private:
+    void Dissect(std::vector<NodeID> cell, const std::uint32_t cell_id, const std::uint32_t depth);
+    NodeID BreadthFirstSearch(const NodeID start,
+                              const std::uint32_t cell_id,
+                              std::vector<NodeID> &order);
+    std::uint32_t NextCellID();
+
+    // undirected adjacency array of the edge-based graph
+    std::vector<std::uint64_t> first_edge;
+    std::vector<NodeID> targets;
+
+    // Per-node scratch space. Concurrently processed cells never share an edge, so the
+    // recursion can run in parallel without synchronising on these vectors.
+    std::vector<std::uint32_t> cell_of_node;
+    std::vector<std::uint32_t> bfs_level;
+    std::vector<std::uint32_t> separator_depth;
+
+    std::atomic<std::uint32_t> next_cell_id;
+};
+}
+}
+
+#endif // NESTED_DISSECTION_HPP
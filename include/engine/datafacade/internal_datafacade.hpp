@@ -17,6 +17,8 @@
 #include "util/static_rtree.hpp"
 #include "util/range_table.hpp"
 #include "util/graph_loader.hpp"
+#include "util/lazy_mapped_file.hpp"
+#include "util/make_unique.hpp"
 #include "util/simple_logger.hpp"
 #include "util/rectangle.hpp"
 #include "extractor/compressed_edge_container.hpp"
@@ -73,12 +75,8 @@ class InternalDataFacade final : public BaseDataFacade
     util::ShM<unsigned, false>::vector m_name_ID_list;
     util::ShM<extractor::guidance::TurnInstruction, false>::vector m_turn_instruction_list;
     util::ShM<extractor::TravelMode, false>::vector m_travel_mode_list;
-    util::ShM<char, false>::vector m_names_char_list;
-    util::ShM<unsigned, false>::vector m_geometry_indices;
-    util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, false>::vector m_geometry_list;
     util::ShM<bool, false>::vector m_is_core_node;
     util::ShM<unsigned, false>::vector m_segment_weights;
-    util::ShM<uint8_t, false>::vector m_datasource_list;
     util::ShM<std::string, false>::vector m_datasource_names;
     extractor::ProfileProperties m_profile_properties;
 
@@ -88,6 +86,41 @@ class InternalDataFacade final : public BaseDataFacade
     boost::filesystem::path file_index_path;
     util::RangeTable<16, false> m_name_table;
 
+    // Geometries, street names and datasources are mapped on first use. Queries like table or
+    // nearest read only a few pages of them, so most of these files never need to be loaded.
+    std::unique_ptr<util::LazyMappedFile> m_geometry_file;
+    unsigned m_number_of_geometry_indices;
+    unsigned m_number_of_compressed_geometries;
+    std::unique_ptr<util::LazyMappedFile> m_names_file;
+    std::size_t m_names_char_offset;
+    unsigned m_number_of_chars;
+    std::unique_ptr<util::LazyMappedFile> m_datasource_indexes_file;
+    std::size_t m_number_of_datasources;
+
+    util::ShM<unsigned, true>::vector GetGeometryIndices() const
+    {
+        return m_geometry_file->GetView<unsigned>(sizeof(unsigned), m_number_of_geometry_indices);
+    }
+
+    util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, true>::vector
+    GetGeometryList() const
+    {
+        return m_geometry_file->GetView<extractor::CompressedEdgeContainer::CompressedEdge>(
+            (m_number_of_geometry_indices + 2) * sizeof(unsigned),
+            m_number_of_compressed_geometries);
+    }
+
+    util::ShM<char, true>::vector GetNamesCharList() const
+    {
+        return m_names_file->GetView<char>(m_names_char_offset, m_number_of_chars);
+    }
+
+    util::ShM<uint8_t, true>::vector GetDatasourceList() const
+    {
+        return m_datasource_indexes_file->GetView<uint8_t>(sizeof(std::size_t),
+                                                           m_number_of_datasources);
+    }
+
     void LoadProfileProperties(const boost::filesystem::path &properties_path)
     {
         boost::filesystem::ifstream in_stream(properties_path);
@@ -192,29 +225,26 @@ class InternalDataFacade final : public BaseDataFacade
     void LoadGeometries(const boost::filesystem::path &geometry_file)
     {
         std::ifstream geometry_stream(geometry_file.string().c_str(), std::ios::binary);
-        unsigned number_of_indices = 0;
-        unsigned number_of_compressed_geometries = 0;
-
-        geometry_stream.read((char *)&number_of_indices, sizeof(unsigned));
+        m_number_of_geometry_indices = 0;
+        m_number_of_compressed_geometries = 0;
 
-        m_geometry_indices.resize(number_of_indices);
-        if (number_of_indices > 0)
+        // only read the sizes and the last index, the indices and geometries follow them
+        geometry_stream.read((char *)&m_number_of_geometry_indices, sizeof(unsigned));
+        unsigned last_geometry_index = 0;
+        if (m_number_of_geometry_indices > 0)
         {
-            geometry_stream.read((char *)&(m_geometry_indices[0]),
-                                 number_of_indices * sizeof(unsigned));
+            geometry_stream.seekg((m_number_of_geometry_indices - 1) * sizeof(unsigned),
+                                  std::ios::cur);
+            geometry_stream.read((char *)&last_geometry_index, sizeof(unsigned));
         }
-
-        geometry_stream.read((char *)&number_of_compressed_geometries, sizeof(unsigned));
-
-        BOOST_ASSERT(m_geometry_indices.back() == number_of_compressed_geometries);
-        m_geometry_list.resize(number_of_compressed_geometries);
-
-        if (number_of_compressed_geometries > 0)
+        geometry_stream.read((char *)&m_number_of_compressed_geometries, sizeof(unsigned));
+        if (!geometry_stream)
         {
-            geometry_stream.read((char *)&(m_geometry_list[0]),
-                                 number_of_compressed_geometries *
-                                     sizeof(extractor::CompressedEdgeContainer::CompressedEdge));
+            throw util::exception("Could not read " + geometry_file.string());
         }
+        BOOST_ASSERT(last_geometry_index == m_number_of_compressed_geometries);
+
+        m_geometry_file = util::make_unique<util::LazyMappedFile>(geometry_file);
     }
 
     void LoadDatasourceInfo(const boost::filesystem::path &datasource_names_file,
@@ -227,15 +257,11 @@ class InternalDataFacade final : public BaseDataFacade
         }
         BOOST_ASSERT(datasources_stream);
 
-        std::size_t number_of_datasources = 0;
-        datasources_stream.read(reinterpret_cast<char *>(&number_of_datasources),
+        m_number_of_datasources = 0;
+        datasources_stream.read(reinterpret_cast<char *>(&m_number_of_datasources),
                                 sizeof(std::size_t));
-        if (number_of_datasources > 0)
-        {
-            m_datasource_list.resize(number_of_datasources);
-            datasources_stream.read(reinterpret_cast<char *>(&(m_datasource_list[0])),
-                                    number_of_datasources * sizeof(uint8_t));
-        }
+        m_datasource_indexes_file =
+            util::make_unique<util::LazyMappedFile>(datasource_indexes_file);
 
         boost::filesystem::ifstream datasourcenames_stream(datasource_names_file, std::ios::binary);
         if (!datasourcenames_stream)
@@ -265,15 +291,16 @@ class InternalDataFacade final : public BaseDataFacade
 
         name_stream >> m_name_table;
 
-        unsigned number_of_chars = 0;
-        name_stream.read((char *)&number_of_chars, sizeof(unsigned));
-        BOOST_ASSERT_MSG(0 != number_of_chars, "name file broken");
-        m_names_char_list.resize(number_of_chars + 1); //+1 gives sentinel element
-        name_stream.read((char *)&m_names_char_list[0], number_of_chars * sizeof(char));
-        if (0 == m_names_char_list.size())
+        m_number_of_chars = 0;
+        name_stream.read((char *)&m_number_of_chars, sizeof(unsigned));
+        BOOST_ASSERT_MSG(0 != m_number_of_chars, "name file broken");
+        if (0 == m_number_of_chars)
         {
             util::SimpleLogger().Write(logWARNING) << "list of street names is empty";
         }
+        // the characters are mapped, only the index of the names is read
+        m_names_char_offset = static_cast<std::size_t>(name_stream.tellg());
+        m_names_file = util::make_unique<util::LazyMappedFile>(names_file);
     }
 
   public:
@@ -281,6 +308,19 @@ class InternalDataFacade final : public BaseDataFacade
     {
         m_static_rtree.reset();
         m_geospatial_query.reset();
+
+        // shows how much of the lazily mapped data the queries of this process needed
+        const auto log_resident_size = [](const char *name,
+                                          const std::unique_ptr<util::LazyMappedFile> &file) {
+            if (file)
+            {
+                util::SimpleLogger().Write() << name << ": " << file->GetResidentSize()
+                                             << " bytes resident";
+            }
+        };
+        log_resident_size("geometries", m_geometry_file);
+        log_resident_size("street names", m_names_file);
+        log_resident_size("datasources", m_datasource_indexes_file);
     }
 
     explicit InternalDataFacade(const storage::StorageConfig& config)
@@ -553,9 +593,10 @@ class InternalDataFacade final : public BaseDataFacade
         result.reserve(range.size());
         if (range.begin() != range.end())
         {
+            const auto names_char_list = GetNamesCharList();
             result.resize(range.back() - range.front() + 1);
-            std::copy(m_names_char_list.begin() + range.front(),
-                      m_names_char_list.begin() + range.back() + 1, result.begin());
+            std::copy(names_char_list.begin() + range.front(),
+                      names_char_list.begin() + range.back() + 1, result.begin());
         }
         return result;
     }
@@ -582,12 +623,14 @@ class InternalDataFacade final : public BaseDataFacade
     virtual void GetUncompressedGeometry(const EdgeID id,
                                          std::vector<NodeID> &result_nodes) const override final
     {
-        const unsigned begin = m_geometry_indices.at(id);
-        const unsigned end = m_geometry_indices.at(id + 1);
+        const auto geometry_indices = GetGeometryIndices();
+        const unsigned begin = geometry_indices.at(id);
+        const unsigned end = geometry_indices.at(id + 1);
 
         result_nodes.clear();
         result_nodes.reserve(end - begin);
-        std::for_each(m_geometry_list.begin() + begin, m_geometry_list.begin() + end,
+        const auto geometry_list = GetGeometryList();
+        std::for_each(geometry_list.begin() + begin, geometry_list.begin() + end,
                       [&](const osrm::extractor::CompressedEdgeContainer::CompressedEdge &edge)
                       {
                           result_nodes.emplace_back(edge.node_id);
@@ -598,12 +641,14 @@ class InternalDataFacade final : public BaseDataFacade
     GetUncompressedWeights(const EdgeID id,
                            std::vector<EdgeWeight> &result_weights) const override final
     {
-        const unsigned begin = m_geometry_indices.at(id);
-        const unsigned end = m_geometry_indices.at(id + 1);
+        const auto geometry_indices = GetGeometryIndices();
+        const unsigned begin = geometry_indices.at(id);
+        const unsigned end = geometry_indices.at(id + 1);
 
         result_weights.clear();
         result_weights.reserve(end - begin);
-        std::for_each(m_geometry_list.begin() + begin, m_geometry_list.begin() + end,
+        const auto geometry_list = GetGeometryList();
+        std::for_each(geometry_list.begin() + begin, geometry_list.begin() + end,
                       [&](const osrm::extractor::CompressedEdgeContainer::CompressedEdge &edge)
                       {
                           result_weights.emplace_back(edge.weight);
@@ -616,14 +661,16 @@ class InternalDataFacade final : public BaseDataFacade
     GetUncompressedDatasources(const EdgeID id,
                                std::vector<uint8_t> &result_datasources) const override final
     {
-        const unsigned begin = m_geometry_indices.at(id);
-        const unsigned end = m_geometry_indices.at(id + 1);
+        const auto geometry_indices = GetGeometryIndices();
+        const unsigned begin = geometry_indices.at(id);
+        const unsigned end = geometry_indices.at(id + 1);
 
         result_datasources.clear();
         result_datasources.reserve(end - begin);
 
         // If there was no datasource info, return an array of 0's.
-        if (m_datasource_list.empty())
+        const auto datasource_list = GetDatasourceList();
+        if (datasource_list.empty())
         {
             for (unsigned i = 0; i < end - begin; ++i)
             {
@@ -632,7 +679,7 @@ class InternalDataFacade final : public BaseDataFacade
         }
         else
         {
-            std::for_each(m_datasource_list.begin() + begin, m_datasource_list.begin() + end,
+            std::for_each(datasource_list.begin() + begin, datasource_list.begin() + end,
                           [&](const uint8_t &datasource_id)
                           {
                               result_datasources.push_back(datasource_id);
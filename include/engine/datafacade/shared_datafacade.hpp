@@ -1,9 +1,10 @@
 #ifndef SHARED_DATAFACADE_HPP
 #define SHARED_DATAFACADE_HPP
 
-// implements all data storage when shared memory _IS_ used
+// implements all data storage when shared memory _IS_ used, or a dataset container is mapped
 
 #include "engine/datafacade/datafacade_base.hpp"
+#include "storage/dataset_container.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 
@@ -15,6 +16,8 @@
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/make_unique.hpp"
+#include "util/packed_pair_list.hpp"
+#include "util/process_memory.hpp"
 #include "util/simple_logger.hpp"
 #include "util/rectangle.hpp"
 
@@ -29,8 +32,6 @@
 
 #include <boost/assert.hpp>
 #include <boost/thread/tss.hpp>
-#include <boost/thread/shared_mutex.hpp>
-#include <boost/thread/lock_guard.hpp>
 
 namespace osrm
 {
@@ -41,6 +42,44 @@ namespace datafacade
 
 class SharedDataFacade final : public BaseDataFacade
 {
+    // Coordinates from either the plain or the packed block, whichever the layout has
+    class CoordinateList
+    {
+      public:
+        CoordinateList(util::ShM<util::Coordinate, true>::vector coordinates,
+                       util::PackedPairList packed_coordinates)
+            : coordinates(std::move(coordinates)), packed_coordinates(packed_coordinates)
+        {
+        }
+
+        util::Coordinate operator[](const std::size_t index) const
+        {
+            if (packed_coordinates.empty())
+            {
+                return coordinates[index];
+            }
+            const auto coordinate = packed_coordinates.at(index);
+            return util::Coordinate(util::FixedLongitude(coordinate.first),
+                                    util::FixedLatitude(coordinate.second));
+        }
+
+        util::Coordinate at(const std::size_t index) const
+        {
+            BOOST_ASSERT(index < size());
+            return (*this)[index];
+        }
+
+        std::size_t size() const
+        {
+            return packed_coordinates.empty() ? coordinates.size() : packed_coordinates.size();
+        }
+
+        bool empty() const { return 0 == size(); }
+
+      private:
+        util::ShM<util::Coordinate, true>::vector coordinates;
+        util::PackedPairList packed_coordinates;
+    };
 
   private:
     using super = BaseDataFacade;
@@ -50,28 +89,32 @@ class SharedDataFacade final : public BaseDataFacade
     using NameIndexBlock = typename util::RangeTable<16, true>::BlockT;
     using InputEdge = typename QueryGraph::InputEdge;
     using RTreeLeaf = typename super::RTreeLeaf;
-    using SharedRTree =
-        util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>;
+    using SharedRTree = util::StaticRTree<RTreeLeaf, CoordinateList, true>;
     using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade>;
     using TimeStampedRTreePair = std::pair<unsigned, std::shared_ptr<SharedRTree>>;
     using RTreeNode = typename SharedRTree::TreeNode;
 
-    storage::SharedDataLayout *data_layout;
+    const storage::SharedDataLayout *data_layout;
     char *shared_memory;
     storage::SharedDataTimestamp *data_timestamp_ptr;
 
     storage::SharedDataType CURRENT_LAYOUT;
     storage::SharedDataType CURRENT_DATA;
     unsigned CURRENT_TIMESTAMP;
+    std::unique_ptr<storage::SharedMemory> m_timestamp_memory;
+    // names the shared memory regions to read from, empty for the default dataset
+    std::string m_dataset_name;
 
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
     std::unique_ptr<storage::SharedMemory> m_layout_memory;
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    // only set if the data comes from a mapped container instead of shared memory
+    std::unique_ptr<storage::DatasetContainer> m_container;
     std::string m_timestamp;
     extractor::ProfileProperties* m_profile_properties;
 
-    std::shared_ptr<util::ShM<util::Coordinate, true>::vector> m_coordinate_list;
+    std::shared_ptr<CoordinateList> m_coordinate_list;
     util::ShM<NodeID, true>::vector m_via_node_list;
     util::ShM<unsigned, true>::vector m_name_ID_list;
     util::ShM<extractor::guidance::TurnInstruction, true>::vector m_turn_instruction_list;
@@ -80,6 +123,8 @@ class SharedDataFacade final : public BaseDataFacade
     util::ShM<unsigned, true>::vector m_name_begin_indices;
     util::ShM<unsigned, true>::vector m_geometry_indices;
     util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, true>::vector m_geometry_list;
+    // pairs of node id and weight, used instead of m_geometry_list if not empty
+    util::PackedPairList m_packed_geometry_list;
     util::ShM<bool, true>::vector m_is_core_node;
     util::ShM<uint8_t, true>::vector m_datasource_list;
 
@@ -146,13 +191,25 @@ class SharedDataFacade final : public BaseDataFacade
         m_query_graph.reset(new QueryGraph(node_list, edge_list));
     }
 
+    // Empty list if the dataset wasn't compressed
+    util::PackedPairList LoadPackedPairList(const storage::SharedDataLayout::BlockID bid) const
+    {
+        if (0 == data_layout->num_entries[bid])
+        {
+            return util::PackedPairList();
+        }
+        return util::PackedPairList(data_layout->GetBlockPtr<char>(shared_memory, bid));
+    }
+
     void LoadNodeAndEdgeInformation()
     {
         auto coordinate_list_ptr = data_layout->GetBlockPtr<util::Coordinate>(
             shared_memory, storage::SharedDataLayout::COORDINATE_LIST);
-        m_coordinate_list = util::make_unique<util::ShM<util::Coordinate, true>::vector>(
-            coordinate_list_ptr,
-            data_layout->num_entries[storage::SharedDataLayout::COORDINATE_LIST]);
+        m_coordinate_list = util::make_unique<CoordinateList>(
+            util::ShM<util::Coordinate, true>::vector(
+                coordinate_list_ptr,
+                data_layout->num_entries[storage::SharedDataLayout::COORDINATE_LIST]),
+            LoadPackedPairList(storage::SharedDataLayout::PACKED_COORDINATE_LIST));
 
         auto travel_mode_list_ptr = data_layout->GetBlockPtr<extractor::TravelMode>(
             shared_memory, storage::SharedDataLayout::TRAVEL_MODE);
@@ -236,6 +293,8 @@ class SharedDataFacade final : public BaseDataFacade
             geometry_list(geometries_list_ptr,
                           data_layout->num_entries[storage::SharedDataLayout::GEOMETRIES_LIST]);
         m_geometry_list = std::move(geometry_list);
+        m_packed_geometry_list =
+            LoadPackedPairList(storage::SharedDataLayout::PACKED_GEOMETRIES_LIST);
 
         auto datasources_list_ptr = data_layout->GetBlockPtr<uint8_t>(
             shared_memory, storage::SharedDataLayout::DATASOURCES_LIST);
@@ -266,104 +325,134 @@ class SharedDataFacade final : public BaseDataFacade
         m_datasource_name_lengths = std::move(datasource_name_lengths);
     }
 
+    // Sets up the views on the blocks of data_layout and shared_memory
+    void LoadData()
+    {
+        const auto file_index_ptr = data_layout->GetBlockPtr<char>(
+            shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
+        file_index_path = boost::filesystem::path(file_index_ptr);
+        if (!boost::filesystem::exists(file_index_path))
+        {
+            util::SimpleLogger().Write(logDEBUG) << "Leaf file name " << file_index_path.string();
+            throw util::exception("Could not load leaf index file. "
+                                  "Is any data loaded into shared memory?");
+        }
+
+        LoadGraph();
+        LoadChecksum();
+        LoadNodeAndEdgeInformation();
+        LoadGeometries();
+        LoadTimestamp();
+        LoadViaNodeList();
+        LoadNames();
+        LoadCoreInformation();
+        LoadProfileProperties();
+
+        util::SimpleLogger().Write() << "number of geometries: " << m_coordinate_list->size();
+        for (unsigned i = 0; i < m_coordinate_list->size(); ++i)
+        {
+            if (!GetCoordinateOfNode(i).IsValid())
+            {
+                util::SimpleLogger().Write() << "coordinate " << i << " not valid";
+            }
+        }
+    }
+
   public:
     virtual ~SharedDataFacade() {}
 
-    boost::shared_mutex data_mutex;
-
-    SharedDataFacade()
+    // Loads the dataset currently published in shared memory
+    explicit SharedDataFacade(std::string dataset_name = "")
+        : m_dataset_name(std::move(dataset_name))
     {
-        if (!storage::SharedMemory::RegionExists(storage::CURRENT_REGIONS))
+        if (!storage::SharedMemory::RegionExists(storage::CURRENT_REGIONS, m_dataset_name))
         {
             throw util::exception(
                 "No shared memory blocks found, have you forgotten to run osrm-datastore?");
         }
-        data_timestamp_ptr = static_cast<storage::SharedDataTimestamp *>(
-            storage::makeSharedMemory(storage::CURRENT_REGIONS,
-                                      sizeof(storage::SharedDataTimestamp), false, false)
-                ->Ptr());
+        // attach read-only, a writeable region would be removed again by our destructor
+        m_timestamp_memory.reset(storage::makeSharedMemory(storage::CURRENT_REGIONS, 0, false,
+                                                           false, false, m_dataset_name));
+        data_timestamp_ptr = static_cast<storage::SharedDataTimestamp *>(m_timestamp_memory->Ptr());
         CURRENT_LAYOUT = storage::LAYOUT_NONE;
         CURRENT_DATA = storage::DATA_NONE;
         CURRENT_TIMESTAMP = 0;
 
-        // load data
-        CheckAndReloadFacade();
+        Reload();
     }
 
-    void CheckAndReloadFacade()
+    // Serves the dataset straight out of a read-only mapping of a dataset container. All
+    // processes mapping the same container share its pages in the page cache.
+    explicit SharedDataFacade(const boost::filesystem::path &dataset_path)
+        : data_timestamp_ptr(nullptr), CURRENT_LAYOUT(storage::LAYOUT_NONE),
+          CURRENT_DATA(storage::DATA_NONE), CURRENT_TIMESTAMP(0),
+          m_container(util::make_unique<storage::DatasetContainer>(dataset_path))
     {
-        if (CURRENT_LAYOUT != data_timestamp_ptr->layout ||
-            CURRENT_DATA != data_timestamp_ptr->data ||
-            CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp)
-        {
-            // Get exclusive lock
-            util::SimpleLogger().Write(logDEBUG) << "Updates available, getting exclusive lock";
-            const boost::lock_guard<boost::shared_mutex> lock(data_mutex);
-
-            if (CURRENT_LAYOUT != data_timestamp_ptr->layout ||
-                CURRENT_DATA != data_timestamp_ptr->data)
-            {
-                // release the previous shared memory segments
-                storage::SharedMemory::Remove(CURRENT_LAYOUT);
-                storage::SharedMemory::Remove(CURRENT_DATA);
+        data_layout = &m_container->GetLayout();
+        shared_memory = m_container->GetDataPtr();
+        LoadData();
+    }
 
-                CURRENT_LAYOUT = data_timestamp_ptr->layout;
-                CURRENT_DATA = data_timestamp_ptr->data;
-                CURRENT_TIMESTAMP = 0; // Force trigger a reload
+    // True if osrm-datastore published a dataset other than the loaded one
+    bool IsOutdated() const
+    {
+        if (m_container)
+        {
+            // a mapped container never changes
+            return false;
+        }
+        return CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp ||
+               CURRENT_LAYOUT != data_timestamp_ptr->layout ||
+               CURRENT_DATA != data_timestamp_ptr->data;
+    }
 
-                util::SimpleLogger().Write(logDEBUG)
-                    << "Current layout was different to new layout, swapping";
-            }
-            else
-            {
-                util::SimpleLogger().Write(logDEBUG)
-                    << "Current layout was same to new layout, not swapping";
-            }
+    // Loads the dataset currently published in shared memory. No query may use the facade
+    // meanwhile, so updates load into a facade that is not in use and swap it in.
+    void Reload()
+    {
+        BOOST_ASSERT(!m_container);
+        // osrm-datastore updates the timestamp last, so reading it first might only
+        // make us load the same dataset again
+        CURRENT_TIMESTAMP = data_timestamp_ptr->timestamp;
+        CURRENT_LAYOUT = data_timestamp_ptr->layout;
+        CURRENT_DATA = data_timestamp_ptr->data;
 
-            if (CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp)
-            {
-                CURRENT_TIMESTAMP = data_timestamp_ptr->timestamp;
+        util::SimpleLogger().Write(logDEBUG) << "Performing data reload";
+        m_layout_memory.reset(
+            storage::makeSharedMemory(CURRENT_LAYOUT, 0, false, true, false, m_dataset_name));
+        data_layout = static_cast<storage::SharedDataLayout *>(m_layout_memory->Ptr());
 
-                util::SimpleLogger().Write(logDEBUG) << "Performing data reload";
-                m_layout_memory.reset(storage::makeSharedMemory(CURRENT_LAYOUT));
+        m_large_memory.reset(
+            storage::makeSharedMemory(CURRENT_DATA, 0, false, true, false, m_dataset_name));
+        shared_memory = (char *)(m_large_memory->Ptr());
 
-                data_layout = static_cast<storage::SharedDataLayout *>(m_layout_memory->Ptr());
+        LoadData();
+    }
 
-                m_large_memory.reset(storage::makeSharedMemory(CURRENT_DATA));
-                shared_memory = (char *)(m_large_memory->Ptr());
+    // Detaches from the loaded dataset, so that its memory can be freed. Only Reload() may
+    // be called afterwards.
+    void Release()
+    {
+        BOOST_ASSERT(!m_container);
+        m_layout_memory.reset();
+        m_large_memory.reset();
+        CURRENT_LAYOUT = storage::LAYOUT_NONE;
+        CURRENT_DATA = storage::DATA_NONE;
+        CURRENT_TIMESTAMP = 0;
+    }
 
-                const auto file_index_ptr = data_layout->GetBlockPtr<char>(
-                    shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
-                file_index_path = boost::filesystem::path(file_index_ptr);
-                if (!boost::filesystem::exists(file_index_path))
-                {
-                    util::SimpleLogger().Write(logDEBUG) << "Leaf file name "
-                                                         << file_index_path.string();
-                    throw util::exception("Could not load leaf index file. "
-                                          "Is any data loaded into shared memory?");
-                }
-
-                LoadGraph();
-                LoadChecksum();
-                LoadNodeAndEdgeInformation();
-                LoadGeometries();
-                LoadTimestamp();
-                LoadViaNodeList();
-                LoadNames();
-                LoadCoreInformation();
-                LoadProfileProperties();
-
-                util::SimpleLogger().Write() << "number of geometries: "
-                                             << m_coordinate_list->size();
-                for (unsigned i = 0; i < m_coordinate_list->size(); ++i)
-                {
-                    if (!GetCoordinateOfNode(i).IsValid())
-                    {
-                        util::SimpleLogger().Write() << "coordinate " << i << " not valid";
-                    }
-                }
-            }
-            util::SimpleLogger().Write(logDEBUG) << "Releasing exclusive lock";
+    // Faults in the blocks every query reads, so that the first queries on a freshly loaded
+    // dataset don't have to. Touches the whole graph and the inner nodes of the R-tree.
+    void Prefault() const
+    {
+        for (const auto bid : {storage::SharedDataLayout::GRAPH_NODE_LIST,
+                               storage::SharedDataLayout::GRAPH_EDGE_LIST,
+                               storage::SharedDataLayout::R_SEARCH_TREE,
+                               storage::SharedDataLayout::COORDINATE_LIST,
+                               storage::SharedDataLayout::PACKED_COORDINATE_LIST})
+        {
+            util::prefaultMemory(data_layout->GetBlockPtr<char>(shared_memory, bid),
+                                 data_layout->GetBlockSize(bid));
         }
     }
 
@@ -424,6 +513,15 @@ class SharedDataFacade final : public BaseDataFacade
 
         result_nodes.clear();
         result_nodes.reserve(end - begin);
+        if (!m_packed_geometry_list.empty())
+        {
+            m_packed_geometry_list.ForEach(
+                begin, end, [&](const util::PackedPairList::Pair &edge)
+                {
+                    result_nodes.emplace_back(static_cast<NodeID>(edge.first));
+                });
+            return;
+        }
         std::for_each(m_geometry_list.begin() + begin, m_geometry_list.begin() + end,
                       [&](const osrm::extractor::CompressedEdgeContainer::CompressedEdge &edge)
                       {
@@ -440,6 +538,15 @@ class SharedDataFacade final : public BaseDataFacade
 
         result_weights.clear();
         result_weights.reserve(end - begin);
+        if (!m_packed_geometry_list.empty())
+        {
+            m_packed_geometry_list.ForEach(
+                begin, end, [&](const util::PackedPairList::Pair &edge)
+                {
+                    result_weights.emplace_back(edge.second);
+                });
+            return;
+        }
         std::for_each(m_geometry_list.begin() + begin, m_geometry_list.begin() + end,
                       [&](const osrm::extractor::CompressedEdgeContainer::CompressedEdge &edge)
                       {
@@ -0,0 +1,190 @@
+#ifndef DATASET_EPOCHS_HPP
+#define DATASET_EPOCHS_HPP
+
+#include <boost/thread/tss.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Lets queries pin the loaded dataset without taking a lock.
+ *
+ * The dataset is swapped through a pointer. Every reader thread owns a slot in
+ * which it publishes the generation it pinned, so a query only writes to a cache
+ * line of its own thread. After publishing the new data, Synchronize() advances
+ * the generation and waits until no slot holds the previous one, after which the
+ * old data can be freed. Readers arriving during the wait pin the new generation
+ * and never block.
+ *
+ * The slots are shared with the reader threads, so threads may outlive the DatasetEpochs
+ * they pinned.
+ */
+class DatasetEpochs
+{
+    using Generation = std::uint64_t;
+    static constexpr const Generation UNPINNED = std::numeric_limits<Generation>::max();
+
+    // keeps slots of different threads on different cache lines
+    struct alignas(64) ReaderSlot
+    {
+        explicit ReaderSlot(void *memory_)
+            : pinned(UNPINNED), in_use(true), next(nullptr), memory(memory_)
+        {
+        }
+
+        std::atomic<Generation> pinned;
+        std::atomic<bool> in_use;
+        ReaderSlot *next;
+        // operator new honours the alignment only from C++17 on
+        void *memory;
+    };
+
+    // Slots are never unlinked, so writers can walk the list without synchronizing with
+    // readers. The list is freed when the DatasetEpochs and all reader threads are gone.
+    struct SlotList
+    {
+        SlotList() : head(nullptr) {}
+        ~SlotList()
+        {
+            for (auto *slot = head.load(); slot != nullptr;)
+            {
+                auto *next = slot->next;
+                void *memory = slot->memory;
+                slot->~ReaderSlot();
+                ::operator delete(memory);
+                slot = next;
+            }
+        }
+
+        std::atomic<ReaderSlot *> head;
+    };
+
+    // hands the slot back when its thread exits
+    struct SlotHandle
+    {
+        SlotHandle(std::shared_ptr<SlotList> list_, ReaderSlot &slot_)
+            : list(std::move(list_)), slot(slot_)
+        {
+        }
+        ~SlotHandle() { slot.in_use.store(false, std::memory_order_release); }
+
+        std::shared_ptr<SlotList> list;
+        ReaderSlot &slot;
+    };
+
+  public:
+    // Pins the current dataset for the lifetime of the guard
+    class ReadGuard
+    {
+      public:
+        explicit ReadGuard(DatasetEpochs &epochs) : slot(epochs.Pin()) {}
+        ~ReadGuard() { slot.pinned.store(UNPINNED, std::memory_order_release); }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+      private:
+        ReaderSlot &slot;
+    };
+
+    DatasetEpochs() : current_generation(0), slots(std::make_shared<SlotList>()) {}
+
+    // handles of other threads keep the slot list alive until these threads exit
+    ~DatasetEpochs() { local_slot.reset(); }
+
+    DatasetEpochs(const DatasetEpochs &) = delete;
+    DatasetEpochs &operator=(const DatasetEpochs &) = delete;
+
+    // Waits until no reader pinned before the call is left, without blocking new readers
+    void Synchronize()
+    {
+        // a concurrent writer might free data that readers of older generations still use
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        WaitForReaders(current_generation.fetch_add(1));
+    }
+
+  private:
+    ReaderSlot &Pin()
+    {
+        ReaderSlot &slot = GetLocalSlot();
+        while (true)
+        {
+            const Generation generation = current_generation.load();
+            slot.pinned.store(generation);
+            // A writer might have advanced the generation between the load and the store and
+            // not see this pin. Later writers would only wait for the new generation.
+            if (generation == current_generation.load())
+            {
+                return slot;
+            }
+        }
+    }
+
+    // Queries are short, so yielding beats sleeping here. The loads are sequentially
+    // consistent, so they can't be ordered before the update of the generation.
+    void WaitForReaders(const Generation previous)
+    {
+        for (auto *slot = slots->head.load(); slot != nullptr; slot = slot->next)
+        {
+            while (previous == slot->pinned.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    ReaderSlot &GetLocalSlot()
+    {
+        // the handle might be left over from a destroyed DatasetEpochs at the same address
+        if (!local_slot.get() || local_slot->list != slots)
+        {
+            local_slot.reset(new SlotHandle(slots, AcquireSlot()));
+        }
+        return local_slot->slot;
+    }
+
+    // Reuses the slot of an exited thread or prepends a new one
+    ReaderSlot &AcquireSlot()
+    {
+        for (auto *slot = slots->head.load(); slot != nullptr; slot = slot->next)
+        {
+            bool is_free = false;
+            if (slot->in_use.compare_exchange_strong(is_free, true))
+            {
+                return *slot;
+            }
+        }
+
+        const auto alignment = alignof(ReaderSlot);
+        void *memory = ::operator new(sizeof(ReaderSlot) + alignment - 1);
+        const auto address = reinterpret_cast<std::uintptr_t>(memory);
+        auto *slot = new (reinterpret_cast<void *>((address + alignment - 1) & ~(alignment - 1)))
+            ReaderSlot(memory);
+        slot->next = slots->head.load();
+        while (!slots->head.compare_exchange_weak(slot->next, slot))
+        {
+        }
+        return *slot;
+    }
+
+    std::atomic<Generation> current_generation;
+    // shared with the slot handles of the reader threads
+    std::shared_ptr<SlotList> slots;
+    std::mutex writer_mutex;
+    boost::thread_specific_ptr<SlotHandle> local_slot;
+};
+}
+}
+
+#endif // DATASET_EPOCHS_HPP
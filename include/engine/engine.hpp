@@ -2,12 +2,12 @@
 #define ENGINE_HPP
 
 #include "engine/status.hpp"
-#include "storage/shared_barriers.hpp"
 #include "util/json_container.hpp"
 
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -52,9 +52,6 @@ class BaseDataFacade;
 class Engine final
 {
   public:
-    // Needs to be public
-    struct EngineLock;
-
     explicit Engine(EngineConfig &config);
 
     Engine(Engine &&) noexcept;
@@ -71,16 +68,22 @@ class Engine final
     Status Tile(const api::TileParameters &parameters, std::string &result);
 
   private:
-    std::unique_ptr<EngineLock> lock;
+    // Data facade and plugins working on one copy of the dataset
+    struct DatasetReplica;
+    // Loads new shared memory datasets in the background and swaps them in
+    class DatasetUpdater;
+
+    const DatasetReplica &LocalReplica() const;
 
-    std::unique_ptr<plugins::ViaRoutePlugin> route_plugin;
-    std::unique_ptr<plugins::TablePlugin> table_plugin;
-    std::unique_ptr<plugins::NearestPlugin> nearest_plugin;
-    std::unique_ptr<plugins::TripPlugin> trip_plugin;
-    std::unique_ptr<plugins::MatchPlugin> match_plugin;
-    std::unique_ptr<plugins::TilePlugin> tile_plugin;
+    // Runs query on the replica the calling thread should use
+    template <typename QueryT> Status RunQuery(const QueryT &query) const;
 
-    std::unique_ptr<datafacade::BaseDataFacade> query_data_facade;
+    // a single replica, or one per NUMA node if replication is enabled
+    std::vector<std::unique_ptr<DatasetReplica>> replicas;
+    // replica used by queries running on a CPU
+    std::vector<unsigned> cpu_to_replica;
+    // holds the replica instead if the dataset comes from shared memory
+    std::unique_ptr<DatasetUpdater> updater;
 };
 }
 }
@@ -53,6 +53,12 @@ namespace engine
  *  - Match
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * The dataset name selects a dataset loaded with osrm-datastore --dataset-name.
+ * A storage config for a dataset container, written by osrm-datastore --write-dataset,
+ * maps the container instead of loading the files.
+ *
+ * On machines with several NUMA nodes, a dataset loaded from files can be replicated
+ * per node. Queries then read the copy on the node of the CPU they run on.
  *
  * \see OSRM, StorageConfig
  */
@@ -66,6 +72,8 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     bool use_shared_memory = true;
+    bool use_numa_replicas = false;
+    std::string dataset_name;
 };
 }
 }
@@ -3,8 +3,7 @@
 
 #include "util/typedefs.hpp"
 
-#include <unordered_map>
-
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -46,10 +45,14 @@ class CompressedEdgeContainer
   private:
     int free_list_maximum = 0;
 
+    static constexpr const unsigned INVALID_BUCKET_INDEX = std::numeric_limits<unsigned>::max();
+
     void IncreaseFreeList();
+    void SetPositionForID(const EdgeID edge_id, const unsigned index);
     std::vector<EdgeBucket> m_compressed_geometries;
     std::vector<unsigned> m_free_list;
-    std::unordered_map<EdgeID, unsigned> m_edge_id_to_list_index_map;
+    // bucket index for every edge id, INVALID_BUCKET_INDEX for edges without a bucket
+    std::vector<unsigned> m_edge_id_to_list_index;
 };
 }
 }
@@ -40,6 +40,8 @@ namespace osrm
 namespace extractor
 {
 
+class ScriptingEnvironment;
+
 class EdgeBasedGraphFactory
 {
   public:
@@ -56,7 +58,7 @@ class EdgeBasedGraphFactory
                                    const util::NameTable &name_table);
 
     void Run(const std::string &original_edge_data_filename,
-             lua_State *lua_state,
+             ScriptingEnvironment &scripting_environment,
              const std::string &edge_segment_lookup_filename,
              const std::string &edge_penalty_filename,
              const bool generate_edge_lookup);
@@ -114,7 +116,7 @@ class EdgeBasedGraphFactory
     unsigned RenumberEdges();
     void GenerateEdgeExpandedNodes();
     void GenerateEdgeExpandedEdges(const std::string &original_edge_data_filename,
-                                   lua_State *lua_state,
+                                   ScriptingEnvironment &scripting_environment,
                                    const std::string &edge_segment_lookup_filename,
                                    const std::string &edge_fixed_penalties_filename,
                                    const bool generate_edge_lookup);
@@ -5,9 +5,13 @@
 #include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/scripting_environment.hpp"
 #include "extractor/external_memory_node.hpp"
+#include "extractor/name_interner.hpp"
+#include "extractor/node_based_graph_data.hpp"
 #include "extractor/restriction.hpp"
 
 #include <stxxl/vector>
+
+#include <cstddef>
 #include <unordered_map>
 
 namespace osrm
@@ -34,11 +38,14 @@ class ExtractionContainers
     void PrepareRestrictions();
     void PrepareEdges(lua_State *segment_state);
 
-    void WriteNodes(std::ofstream &file_out_stream) const;
+    void WriteNodes(std::ofstream &file_out_stream);
     void WriteRestrictions(const std::string &restrictions_file_name) const;
-    void WriteEdges(std::ofstream &file_out_stream) const;
+    void WriteEdges(std::ofstream &file_out_stream);
     void WriteNames(const std::string &names_file_name) const;
 
+    // sorts of data larger than this many bytes are done in external memory
+    std::size_t sort_memory_budget;
+
   public:
     using STXXLNodeIDVector = stxxl::vector<OSMNodeID>;
     using STXXLNodeVector = stxxl::vector<ExternalMemoryNode>;
@@ -49,14 +56,15 @@ class ExtractionContainers
     STXXLNodeIDVector used_node_id_list;
     STXXLNodeVector all_nodes_list;
     STXXLEdgeVector all_edges_list;
-    stxxl::vector<char> name_char_data;
-    stxxl::vector<unsigned> name_lengths;
+    NameInterner name_interner;
     STXXLRestrictionsVector restrictions_list;
     STXXLWayIDStartEndVector way_start_end_id_list;
     std::unordered_map<OSMNodeID, NodeID> external_to_internal_node_id_map;
     unsigned max_internal_node_id;
+    // filled while writing the .osrm file
+    NodeBasedGraphData node_based_graph_data;
 
-    ExtractionContainers();
+    explicit ExtractionContainers(const std::size_t sort_memory_budget);
 
     ~ExtractionContainers();
 
@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "extractor/extractor_config.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/graph_compressor.hpp"
+#include "extractor/node_based_graph_data.hpp"
 
 #include "util/typedefs.hpp"
 
@@ -41,6 +42,7 @@ namespace extractor
 {
 
 struct ProfileProperties;
+class ScriptingEnvironment;
 
 class Extractor
 {
@@ -52,7 +54,8 @@ class Extractor
     ExtractorConfig config;
 
     std::pair<std::size_t, std::size_t>
-    BuildEdgeExpandedGraph(lua_State* lua_state,
+    BuildEdgeExpandedGraph(NodeBasedGraphData node_based_graph_data,
+                           ScriptingEnvironment &scripting_environment,
                            const ProfileProperties& profile_properties,
                            std::vector<QueryNode> &internal_to_external_node_map,
                            std::vector<EdgeBasedNode> &node_based_edge_list,
@@ -69,7 +72,8 @@ class Extractor
                     const std::vector<QueryNode> &internal_to_external_node_map);
     std::shared_ptr<RestrictionMap> LoadRestrictionMap();
     std::shared_ptr<util::NodeBasedDynamicGraph>
-    LoadNodeBasedGraph(std::unordered_set<NodeID> &barrier_nodes,
+    LoadNodeBasedGraph(NodeBasedGraphData graph_data,
+                       std::unordered_set<NodeID> &barrier_nodes,
                        std::unordered_set<NodeID> &traffic_lights,
                        std::vector<QueryNode> &internal_to_external_node_map);
 
@@ -5,7 +5,6 @@
 #include <boost/optional/optional_fwd.hpp>
 
 #include <string>
-#include <unordered_map>
 
 namespace osmium
 {
@@ -33,8 +32,6 @@ struct ExtractionWay;
 class ExtractorCallbacks
 {
   private:
-    // used to deduplicate street names: actually maps to name ids
-    std::unordered_map<std::string, NodeID> string_map;
     ExtractionContainers &external_memory;
 
   public:
@@ -50,6 +47,7 @@ class ExtractorCallbacks
     void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction);
 
     // warning: caller needs to take care of synchronization!
+    // Only the edge and node lists need it, street names are interned thread-safe.
     void ProcessWay(const osmium::Way &current_way, const ExtractionWay &result_way);
 };
 }
@@ -40,7 +40,7 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
+    ExtractorConfig() noexcept : requested_num_threads(0), sort_memory_budget(4096) {}
     void UseDefaultOutputNames()
     {
         std::string basepath = input_path.string();
@@ -93,6 +93,8 @@ struct ExtractorConfig
 
     unsigned requested_num_threads;
     unsigned small_component_size;
+    //! in MiB, larger data is sorted in external memory
+    unsigned sort_memory_budget;
 
     bool generate_edge_lookup;
     std::string edge_penalty_path;
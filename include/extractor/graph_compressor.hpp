@@ -28,6 +28,13 @@ class GraphCompressor
                   CompressedEdgeContainer &geometry_compressor);
 
   private:
+    // Checks that do not change while other nodes are compressed
+    bool IsCompressionCandidate(const NodeID node_v,
+                                const std::unordered_set<NodeID> &barrier_nodes,
+                                const std::unordered_set<NodeID> &traffic_lights,
+                                const RestrictionMap &restriction_map,
+                                const util::NodeBasedDynamicGraph &graph) const;
+
     void PrintStatistics(unsigned original_number_of_nodes,
                          unsigned original_number_of_edges,
                          const util::NodeBasedDynamicGraph &graph) const;
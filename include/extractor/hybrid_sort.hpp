@@ -0,0 +1,50 @@
+#ifndef HYBRID_SORT_HPP
+#define HYBRID_SORT_HPP
+
+#include <stxxl/sort>
+#include <stxxl/vector>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Sorts an stxxl::vector in memory if it fits into memory_budget bytes and
+ * falls back to the external multiway merge sort of stxxl otherwise.
+ *
+ * The in-memory path reads the vector sequentially into a buffer, sorts it
+ * with tbb::parallel_sort and writes it back. Like stxxl::sort it is not
+ * stable. The comparator has to satisfy the stxxl requirements (min_value()
+ * and max_value()) so both paths accept the same types.
+ */
+template <typename VectorT, typename CompareT>
+void hybridSort(VectorT &vector,
+                CompareT compare,
+                const std::size_t memory_budget,
+                const unsigned stxxl_memory)
+{
+    using value_type = typename VectorT::value_type;
+
+    if (vector.size() * sizeof(value_type) <= memory_budget)
+    {
+        const VectorT &const_vector = vector;
+        std::vector<value_type> buffer(const_vector.begin(), const_vector.end());
+        tbb::parallel_sort(buffer.begin(), buffer.end(), compare);
+        std::copy(buffer.begin(), buffer.end(), vector.begin());
+    }
+    else
+    {
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+    }
+}
+}
+}
+
+#endif // HYBRID_SORT_HPP
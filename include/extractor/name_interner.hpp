@@ -0,0 +1,91 @@
+#ifndef NAME_INTERNER_HPP
+#define NAME_INTERNER_HPP
+
+#include <boost/functional/hash.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <tbb/concurrent_vector.h>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Deduplicates street names and assigns them consecutive ids.
+ *
+ * Names are distributed over independently locked shards by their hash, so
+ * ways can be interned from multiple threads. The characters are copied into
+ * per-shard arenas that live as long as the interner, the lookup tables only
+ * reference them.
+ *
+ * Ids are handed out in the order names are first seen, with the empty name
+ * always having id 0. Interning from a single thread thus yields the same ids
+ * on every run.
+ */
+class NameInterner
+{
+  public:
+    // longer names are stored truncated, but still deduplicated by their full value
+    static constexpr const unsigned MAX_NAME_LENGTH = 255;
+
+    NameInterner();
+
+    NameInterner(const NameInterner &) = delete;
+    NameInterner &operator=(const NameInterner &) = delete;
+
+    // Returns the id of the name, adding it if it was not seen before. Thread-safe.
+    unsigned Intern(const std::string &name);
+
+    // The following must not be called concurrently with Intern
+
+    std::size_t GetNumberOfNames() const;
+    // stored length of every name, by id
+    std::vector<unsigned> GetNameLengths() const;
+    // writes the characters of all names, by id and without separators
+    void WriteNameData(std::ostream &out) const;
+
+  private:
+    static constexpr const unsigned NUMBER_OF_SHARDS = 64;
+    static constexpr const std::size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+    struct StringRefHash
+    {
+        std::size_t operator()(const boost::string_ref &value) const
+        {
+            return boost::hash_range(value.begin(), value.end());
+        }
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<boost::string_ref, unsigned, StringRefHash> ids;
+        std::vector<std::unique_ptr<char[]>> arena;
+        std::size_t arena_block_used = 0;
+
+        boost::string_ref Store(const std::string &name);
+    };
+
+    struct StoredName
+    {
+        const char *data;
+        unsigned length;
+    };
+
+    std::array<Shard, NUMBER_OF_SHARDS> shards;
+    tbb::concurrent_vector<StoredName> names;
+};
+}
+}
+
+#endif // NAME_INTERNER_HPP
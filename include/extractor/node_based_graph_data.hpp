@@ -0,0 +1,33 @@
+#ifndef NODE_BASED_GRAPH_DATA_HPP
+#define NODE_BASED_GRAPH_DATA_HPP
+
+#include "extractor/node_based_edge.hpp"
+#include "extractor/query_node.hpp"
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * The node-based graph as written to the .osrm file.
+ *
+ * ExtractionContainers fill this while serializing, so the graph can be
+ * handed to the edge expansion of the same process without reading the
+ * file back in.
+ */
+struct NodeBasedGraphData
+{
+    // indexed by internal node id
+    std::vector<QueryNode> nodes;
+    std::vector<NodeID> barrier_nodes;
+    std::vector<NodeID> traffic_lights;
+    std::vector<NodeBasedEdge> edges;
+};
+}
+}
+
+#endif // NODE_BASED_GRAPH_DATA_HPP
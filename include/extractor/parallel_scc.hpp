@@ -0,0 +1,446 @@
+#ifndef PARALLEL_SCC_HPP
+#define PARALLEL_SCC_HPP
+
+#include "util/typedefs.hpp"
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Computes the strongly connected components of a graph in parallel.
+ *
+ * Follows the multistep approach: nodes without incoming or outgoing edges
+ * are trimmed as singleton components, the giant component is found by a
+ * forward and a backward breadth first search from a pivot, and the rest of
+ * the graph is split up by coloring. Every node starts with its own id as
+ * color and the maximum color is propagated along the edges. A node that
+ * keeps its own color is the root of the component made up of all nodes of
+ * the same color that reach it, which is found by a backward search.
+ *
+ * Drop-in replacement for TarjanSCC on large graphs. Components contain the
+ * same nodes, but are numbered in the order of their smallest node id, which
+ * does not depend on the number of threads.
+ */
+template <typename GraphT> class ParallelSCC
+{
+    std::shared_ptr<const GraphT> m_graph;
+
+    // forward and reverse adjacency of the graph in compressed sparse row format
+    std::vector<EdgeID> out_offsets;
+    std::vector<NodeID> out_targets;
+    std::vector<EdgeID> in_offsets;
+    std::vector<NodeID> in_targets;
+
+    // representative node of the component of each node, SPECIAL_NODEID while unassigned
+    std::vector<std::atomic<NodeID>> representatives;
+
+    std::vector<unsigned> components_index;
+    std::vector<NodeID> component_size_vector;
+    std::size_t size_one_counter;
+
+  public:
+    ParallelSCC(std::shared_ptr<const GraphT> graph)
+        : m_graph(std::move(graph)), components_index(m_graph->GetNumberOfNodes(), SPECIAL_NODEID),
+          size_one_counter(0)
+    {
+        BOOST_ASSERT(m_graph->GetNumberOfNodes() > 0);
+    }
+
+    void run()
+    {
+        TIMER_START(SCC_RUN);
+        const NodeID number_of_nodes = m_graph->GetNumberOfNodes();
+
+        BuildAdjacency();
+
+        representatives = std::vector<std::atomic<NodeID>>(number_of_nodes);
+        ParallelForNodes([this](const NodeID node)
+                         {
+                             representatives[node].store(SPECIAL_NODEID,
+                                                         std::memory_order_relaxed);
+                         });
+
+        Trim();
+        const NodeID pivot = FindPivot();
+        if (SPECIAL_NODEID != pivot)
+        {
+            ForwardBackward(pivot);
+        }
+        do
+        {
+            Trim();
+        } while (Coloring() > 0);
+
+        NumberComponents();
+
+        // release the working memory
+        std::vector<EdgeID>().swap(out_offsets);
+        std::vector<NodeID>().swap(out_targets);
+        std::vector<EdgeID>().swap(in_offsets);
+        std::vector<NodeID>().swap(in_targets);
+        std::vector<std::atomic<NodeID>>().swap(representatives);
+
+        TIMER_STOP(SCC_RUN);
+        util::SimpleLogger().Write() << "SCC run took: " << TIMER_MSEC(SCC_RUN) / 1000. << "s";
+    }
+
+    std::size_t get_number_of_components() const { return component_size_vector.size(); }
+
+    std::size_t get_size_one_count() const { return size_one_counter; }
+
+    unsigned get_component_size(const unsigned component_id) const
+    {
+        return component_size_vector[component_id];
+    }
+
+    unsigned get_component_id(const NodeID node) const { return components_index[node]; }
+
+  private:
+    template <typename FunctionT> void ParallelForNodes(FunctionT function) const
+    {
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, m_graph->GetNumberOfNodes()),
+                          [&function](const tbb::blocked_range<NodeID> &range)
+                          {
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                              {
+                                  function(node);
+                              }
+                          });
+    }
+
+    bool IsAssigned(const NodeID node) const
+    {
+        return SPECIAL_NODEID != representatives[node].load(std::memory_order_relaxed);
+    }
+
+    bool Assign(const NodeID node, NodeID representative)
+    {
+        NodeID unassigned = SPECIAL_NODEID;
+        return representatives[node].compare_exchange_strong(unassigned, representative,
+                                                             std::memory_order_relaxed);
+    }
+
+    void BuildAdjacency()
+    {
+        const NodeID number_of_nodes = m_graph->GetNumberOfNodes();
+
+        out_offsets.resize(number_of_nodes + 1);
+        in_offsets.resize(number_of_nodes + 1);
+        std::vector<std::atomic<EdgeID>> in_degrees(number_of_nodes);
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             in_degrees[node].store(0, std::memory_order_relaxed);
+                         });
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             out_offsets[node] = m_graph->GetOutDegree(node);
+                             for (const auto edge : m_graph->GetAdjacentEdgeRange(node))
+                             {
+                                 in_degrees[m_graph->GetTarget(edge)].fetch_add(
+                                     1, std::memory_order_relaxed);
+                             }
+                         });
+
+        // turn the degrees into offsets, in_degrees becomes the insert position
+        EdgeID out_sum = 0, in_sum = 0;
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            const EdgeID out_degree = out_offsets[node];
+            out_offsets[node] = out_sum;
+            out_sum += out_degree;
+
+            const EdgeID in_degree = in_degrees[node].load(std::memory_order_relaxed);
+            in_offsets[node] = in_sum;
+            in_degrees[node].store(in_sum, std::memory_order_relaxed);
+            in_sum += in_degree;
+        }
+        out_offsets[number_of_nodes] = out_sum;
+        in_offsets[number_of_nodes] = in_sum;
+        BOOST_ASSERT(out_sum == in_sum);
+
+        out_targets.resize(out_sum);
+        in_targets.resize(in_sum);
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             auto position = out_offsets[node];
+                             for (const auto edge : m_graph->GetAdjacentEdgeRange(node))
+                             {
+                                 const NodeID target = m_graph->GetTarget(edge);
+                                 out_targets[position++] = target;
+                                 in_targets[in_degrees[target].fetch_add(
+                                     1, std::memory_order_relaxed)] = node;
+                             }
+                         });
+    }
+
+    bool HasUnassignedNeighbour(const NodeID node,
+                                const std::vector<EdgeID> &offsets,
+                                const std::vector<NodeID> &targets) const
+    {
+        for (auto edge = offsets[node]; edge != offsets[node + 1]; ++edge)
+        {
+            if (targets[edge] != node && !IsAssigned(targets[edge]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Assigns every node that has no unassigned predecessor or successor a component of its
+    // own. Such a node can't be part of a cycle through the remaining graph, no matter in which
+    // order its neighbours are trimmed concurrently.
+    std::size_t Trim()
+    {
+        tbb::enumerable_thread_specific<std::size_t> trimmed(0);
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             if (IsAssigned(node))
+                             {
+                                 return;
+                             }
+                             if (!HasUnassignedNeighbour(node, in_offsets, in_targets) ||
+                                 !HasUnassignedNeighbour(node, out_offsets, out_targets))
+                             {
+                                 Assign(node, node);
+                                 ++trimmed.local();
+                             }
+                         });
+        return trimmed.combine(std::plus<std::size_t>());
+    }
+
+    // The node with the most paths through it is very likely part of the giant component
+    NodeID FindPivot() const
+    {
+        using Candidate = std::pair<std::uint64_t, NodeID>;
+        const auto best = tbb::parallel_reduce(
+            tbb::blocked_range<NodeID>(0, m_graph->GetNumberOfNodes()),
+            Candidate(0, SPECIAL_NODEID),
+            [this](const tbb::blocked_range<NodeID> &range, Candidate best)
+            {
+                for (auto node = range.begin(); node != range.end(); ++node)
+                {
+                    if (IsAssigned(node))
+                    {
+                        continue;
+                    }
+                    const std::uint64_t score =
+                        static_cast<std::uint64_t>(out_offsets[node + 1] - out_offsets[node]) *
+                        (in_offsets[node + 1] - in_offsets[node]);
+                    if (SPECIAL_NODEID == best.second || score > best.first)
+                    {
+                        best = Candidate(score, node);
+                    }
+                }
+                return best;
+            },
+            [](const Candidate &lhs, const Candidate &rhs)
+            {
+                if (SPECIAL_NODEID == rhs.second)
+                {
+                    return lhs;
+                }
+                if (SPECIAL_NODEID == lhs.second)
+                {
+                    return rhs;
+                }
+                return lhs.first >= rhs.first ? lhs : rhs;
+            });
+        return best.second;
+    }
+
+    // Level synchronous breadth first search. visit(from, to) is called for every edge leaving
+    // the frontier and returns true if to should be expanded in the next level.
+    template <typename VisitorT>
+    void Traverse(std::vector<NodeID> frontier,
+                  const std::vector<EdgeID> &offsets,
+                  const std::vector<NodeID> &targets,
+                  VisitorT visit) const
+    {
+        while (!frontier.empty())
+        {
+            tbb::enumerable_thread_specific<std::vector<NodeID>> next_frontiers;
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()),
+                              [&](const tbb::blocked_range<std::size_t> &range)
+                              {
+                                  auto &next_frontier = next_frontiers.local();
+                                  for (auto index = range.begin(); index != range.end(); ++index)
+                                  {
+                                      const NodeID from = frontier[index];
+                                      for (auto edge = offsets[from]; edge != offsets[from + 1];
+                                           ++edge)
+                                      {
+                                          if (visit(from, targets[edge]))
+                                          {
+                                              next_frontier.push_back(targets[edge]);
+                                          }
+                                      }
+                                  }
+                              });
+
+            frontier.clear();
+            next_frontiers.combine_each([&frontier](const std::vector<NodeID> &next_frontier)
+                                        {
+                                            frontier.insert(frontier.end(), next_frontier.begin(),
+                                                            next_frontier.end());
+                                        });
+        }
+    }
+
+    // The component of the pivot consists of all nodes that are reachable from the pivot and
+    // reach the pivot.
+    void ForwardBackward(const NodeID pivot)
+    {
+        std::vector<std::atomic<bool>> is_reachable(m_graph->GetNumberOfNodes());
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             is_reachable[node].store(false, std::memory_order_relaxed);
+                         });
+
+        is_reachable[pivot].store(true, std::memory_order_relaxed);
+        Traverse({pivot}, out_offsets, out_targets, [&](const NodeID, const NodeID to)
+                 {
+                     return !IsAssigned(to) &&
+                            !is_reachable[to].exchange(true, std::memory_order_relaxed);
+                 });
+
+        Assign(pivot, pivot);
+        Traverse({pivot}, in_offsets, in_targets, [&](const NodeID, const NodeID to)
+                 {
+                     return is_reachable[to].load(std::memory_order_relaxed) && Assign(to, pivot);
+                 });
+    }
+
+    // Splits the remaining graph into the components of all nodes that keep their own color.
+    // Returns the number of assigned nodes.
+    std::size_t Coloring()
+    {
+        std::vector<std::atomic<NodeID>> colors(m_graph->GetNumberOfNodes());
+        tbb::enumerable_thread_specific<std::vector<NodeID>> unassigned_nodes;
+        ParallelForNodes([&](const NodeID node)
+                         {
+                             colors[node].store(node, std::memory_order_relaxed);
+                             if (!IsAssigned(node))
+                             {
+                                 unassigned_nodes.local().push_back(node);
+                             }
+                         });
+        std::vector<NodeID> frontier;
+        unassigned_nodes.combine_each([&frontier](const std::vector<NodeID> &nodes)
+                                      {
+                                          frontier.insert(frontier.end(), nodes.begin(),
+                                                          nodes.end());
+                                      });
+        if (frontier.empty())
+        {
+            return 0;
+        }
+
+        // A node is expanded again whenever its color increased. Nodes of finished components
+        // still carry their own id as color and are skipped.
+        Traverse(frontier, out_offsets, out_targets, [&](const NodeID from, const NodeID to)
+                 {
+                     if (IsAssigned(to))
+                     {
+                         return false;
+                     }
+                     const NodeID color = colors[from].load(std::memory_order_relaxed);
+                     NodeID current = colors[to].load(std::memory_order_relaxed);
+                     while (current < color)
+                     {
+                         if (colors[to].compare_exchange_weak(current, color,
+                                                              std::memory_order_relaxed))
+                         {
+                             return true;
+                         }
+                     }
+                     return false;
+                 });
+
+        std::vector<NodeID> roots;
+        std::copy_if(frontier.begin(), frontier.end(), std::back_inserter(roots),
+                     [&colors](const NodeID node)
+                     {
+                         return node == colors[node].load(std::memory_order_relaxed);
+                     });
+        BOOST_ASSERT(!roots.empty());
+        for (const auto root : roots)
+        {
+            Assign(root, root);
+        }
+
+        std::atomic<std::size_t> assigned_nodes(roots.size());
+        Traverse(std::move(roots), in_offsets, in_targets, [&](const NodeID from, const NodeID to)
+                 {
+                     const NodeID color = colors[from].load(std::memory_order_relaxed);
+                     if (colors[to].load(std::memory_order_relaxed) == color && Assign(to, color))
+                     {
+                         assigned_nodes.fetch_add(1, std::memory_order_relaxed);
+                         return true;
+                     }
+                     return false;
+                 });
+        return assigned_nodes.load();
+    }
+
+    void NumberComponents()
+    {
+        const NodeID number_of_nodes = m_graph->GetNumberOfNodes();
+
+        std::vector<unsigned> representative_to_component(number_of_nodes, SPECIAL_NODEID);
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            const NodeID representative = representatives[node].load(std::memory_order_relaxed);
+            BOOST_ASSERT(SPECIAL_NODEID != representative);
+
+            unsigned &component = representative_to_component[representative];
+            if (SPECIAL_NODEID == component)
+            {
+                component = component_size_vector.size();
+                component_size_vector.emplace_back(0);
+            }
+            components_index[node] = component;
+            ++component_size_vector[component];
+        }
+
+        for (const auto component : util::irange<std::size_t>(0, component_size_vector.size()))
+        {
+            if (component_size_vector[component] > 1000)
+            {
+                util::SimpleLogger().Write() << "large component [" << component
+                                             << "]=" << component_size_vector[component];
+            }
+        }
+
+        size_one_counter = std::count_if(component_size_vector.begin(), component_size_vector.end(),
+                                         [](unsigned value)
+                                         {
+                                             return 1 == value;
+                                         });
+    }
+};
+}
+}
+
+#endif /* PARALLEL_SCC_HPP */
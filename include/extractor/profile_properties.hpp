@@ -11,7 +11,8 @@ namespace extractor
 struct ProfileProperties
 {
     ProfileProperties()
-        : traffic_signal_penalty(0), u_turn_penalty(0), allow_u_turn_at_via(false), use_turn_restrictions(false)
+        : traffic_signal_penalty(0), u_turn_penalty(0), allow_u_turn_at_via(false),
+          use_turn_restrictions(false), use_turn_penalty_table(true)
     {
     }
 
@@ -41,6 +42,9 @@ struct ProfileProperties
     int u_turn_penalty;
     bool allow_u_turn_at_via;
     bool use_turn_restrictions;
+    //! evaluate turn_function from a table sampled once, profiles whose turn penalty is not
+    //! a pure function of the angle have to disable this
+    bool use_turn_penalty_table;
 };
 }
 }
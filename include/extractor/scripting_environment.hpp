@@ -3,6 +3,7 @@
 
 #include "extractor/profile_properties.hpp"
 #include "extractor/raster_source.hpp"
+#include "extractor/tag_filter.hpp"
 
 #include "util/lua_util.hpp"
 
@@ -32,6 +33,8 @@ class ScriptingEnvironment
     {
         ProfileProperties properties;
         SourceContainer sources;
+        TagFilter node_tag_filter;
+        TagFilter way_tag_filter;
         util::LuaState state;
     };
 
@@ -44,6 +47,7 @@ class ScriptingEnvironment
 
   private:
     void InitContext(Context &context);
+    TagFilter ReadTagFilter(lua_State *state, const char *function_name) const;
     std::mutex init_mutex;
     std::string file_name;
     tbb::enumerable_thread_specific<std::unique_ptr<Context>> script_contexts;
@@ -0,0 +1,68 @@
+#ifndef TAG_FILTER_HPP
+#define TAG_FILTER_HPP
+
+#include <osmium/osm/tag.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Set of tag keys a profile function looks at. Profiles declare them through
+ * ```get_node_tag_keys``` and ```get_way_tag_keys```, which lets the extractor
+ * skip the lua call for entities that carry none of these keys.
+ *
+ * A filter without keys is inactive and matches everything, so profiles that
+ * do not declare their keys see every entity as before.
+ */
+class TagFilter
+{
+  public:
+    TagFilter() = default;
+    explicit TagFilter(std::vector<std::string> keys_) : keys(std::move(keys_))
+    {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    bool IsActive() const { return !keys.empty(); }
+
+    // True if the filter is inactive or one of the tags has a declared key
+    bool Matches(const osmium::TagList &tags) const
+    {
+        if (!IsActive())
+        {
+            return true;
+        }
+
+        // most entities are untagged, and profiles only declare a handful of keys
+        for (const auto &tag : tags)
+        {
+            const auto is_declared = [&tag](const std::string &key)
+            {
+                return 0 == std::strcmp(tag.key(), key.c_str());
+            };
+            if (std::any_of(keys.begin(), keys.end(), is_declared))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::vector<std::string> &GetKeys() const { return keys; }
+
+  private:
+    std::vector<std::string> keys;
+};
+}
+}
+
+#endif // TAG_FILTER_HPP
@@ -0,0 +1,40 @@
+#ifndef TURN_PENALTY_TABLE_HPP
+#define TURN_PENALTY_TABLE_HPP
+
+#include <functional>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Tabulates a profile's turn function over all turn angles.
+ *
+ * Most profiles compute the turn penalty as a pure function of the angle, so
+ * the function is sampled once at a fixed resolution and turns are evaluated
+ * by linear interpolation between the samples instead of calling into lua.
+ * The samples are the integer penalties that calling the turn function yields,
+ * so an angle on a sample gets exactly that penalty.
+ *
+ * Angles are given as produced by the turn analysis, in [0, 360] degrees with
+ * 180 meaning straight ahead.
+ */
+class TurnPenaltyTable
+{
+  public:
+    // samples per degree of turn angle
+    static constexpr const unsigned RESOLUTION = 10;
+
+    explicit TurnPenaltyTable(const std::function<int(double)> &turn_penalty);
+
+    int GetPenalty(const double angle) const;
+
+  private:
+    std::vector<int> penalties;
+};
+}
+}
+
+#endif // TURN_PENALTY_TABLE_HPP
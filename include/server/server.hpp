@@ -6,6 +6,7 @@
 #include "server/service_handler.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/numa.hpp"
 #include "util/simple_logger.hpp"
 
 #include <boost/asio.hpp>
@@ -28,18 +29,25 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                bool bind_to_numa_nodes = false)
     {
         util::SimpleLogger().Write() << "http 1.1 compression handled by zlib version "
                                      << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(ip_address, ip_port, real_num_threads,
+                                        bind_to_numa_nodes);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const bool bind_to_numa_nodes = false)
+        : thread_pool_size(thread_pool_size), bind_to_numa_nodes(bind_to_numa_nodes),
+          acceptor(io_service),
           new_connection(std::make_shared<Connection>(io_service, request_handler))
     {
         const auto port_string = std::to_string(port);
@@ -62,11 +70,21 @@ class Server
 
     void Run()
     {
+        const util::NumaTopology topology;
         std::vector<std::shared_ptr<std::thread>> threads;
         for (unsigned i = 0; i < thread_pool_size; ++i)
         {
-            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+            // spread the threads evenly, each one handles requests on the node it is bound to
+            const unsigned node = i % topology.NumberOfNodes();
+            std::shared_ptr<std::thread> thread =
+                std::make_shared<std::thread>([this, &topology, node] {
+                    if (bind_to_numa_nodes && !topology.BindCurrentThread(node))
+                    {
+                        util::SimpleLogger().Write(logWARNING) << "could not bind to NUMA node "
+                                                               << node;
+                    }
+                    io_service.run();
+                });
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -96,6 +114,7 @@ class Server
     }
 
     unsigned thread_pool_size;
+    bool bind_to_numa_nodes;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
@@ -3,8 +3,11 @@
 
 #include "server/service/base_service.hpp"
 
+#include "osrm/engine_config.hpp"
 #include "osrm/osrm.hpp"
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace osrm
@@ -26,14 +29,25 @@ struct ParsedURL;
 class ServiceHandler
 {
   public:
+    // Serves the dataset under every profile
     ServiceHandler(osrm::EngineConfig &config);
+    // Serves every dataset under the profile of its name, an empty name matches all other profiles
+    ServiceHandler(std::unordered_map<std::string, osrm::EngineConfig> &configs);
     using ResultT = service::BaseService::ResultT;
 
     engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result);
 
   private:
-    std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
-    OSRM routing_machine;
+    // a routing machine and the services answering from it
+    struct Dataset
+    {
+        explicit Dataset(osrm::EngineConfig &config);
+
+        OSRM routing_machine;
+        std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Dataset>> datasets;
 };
 }
 }
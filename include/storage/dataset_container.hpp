@@ -0,0 +1,76 @@
+#ifndef DATASET_CONTAINER_HPP
+#define DATASET_CONTAINER_HPP
+
+#include "storage/shared_datatype.hpp"
+#include "util/fingerprint.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace osrm
+{
+namespace storage
+{
+
+// Header at the start of a dataset container file
+struct DatasetContainerHeader
+{
+    std::uint64_t magic_number;
+    std::uint32_t version;
+    util::FingerPrint fingerprint;
+    SharedDataLayout layout;
+    // CRC32C of every block
+    std::array<std::uint32_t, SharedDataLayout::NUM_BLOCKS> block_checksums;
+};
+
+static_assert(std::is_trivially_copyable<DatasetContainerHeader>::value,
+              "DatasetContainerHeader is written to disk as it is");
+
+/**
+ * A dataset in a single file that is used by mapping it into memory.
+ *
+ * The header holds the block directory, i.e. the SharedDataLayout, and a checksum of
+ * every block. The data starts at DATA_OFFSET and is an exact image of a shared memory
+ * data region with every block aligned to PAGE_SIZE, so the blocks can be used right
+ * out of the mapping without parsing anything.
+ *
+ * The leaves of the R-tree are not part of the container. They stay in the .fileIndex
+ * file, which the container references by absolute path like a data region does.
+ */
+class DatasetContainer
+{
+  public:
+    static constexpr const std::uint64_t MAGIC_NUMBER = 0x5445534154414453; // "SDATASET"
+    static constexpr const std::uint32_t VERSION = 2;
+    static constexpr const std::uint64_t PAGE_SIZE = 4096;
+    static constexpr const std::uint64_t DATA_OFFSET =
+        (sizeof(DatasetContainerHeader) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+
+    // Maps the container read-only, throws if it isn't a valid container
+    explicit DatasetContainer(const boost::filesystem::path &path);
+
+    const DatasetContainerHeader &GetHeader() const { return *header; }
+    const SharedDataLayout &GetLayout() const { return header->layout; }
+    // Start of the data region, blocks are read with GetLayout().GetBlockPtr()
+    char *GetDataPtr() const { return data; }
+
+    // Checks a block against its checksum, which reads all of the block
+    bool IsBlockValid(const SharedDataLayout::BlockID bid) const;
+
+    static std::uint32_t ComputeChecksum(const char *block, const std::uint64_t size);
+
+  private:
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    const DatasetContainerHeader *header;
+    char *data;
+};
+}
+}
+
+#endif // DATASET_CONTAINER_HPP
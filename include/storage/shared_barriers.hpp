@@ -2,7 +2,8 @@
 #define SHARED_BARRIERS_HPP
 
 #include <boost/interprocess/sync/named_mutex.hpp>
-#include <boost/interprocess/sync/named_condition.hpp>
+
+#include <string>
 
 namespace osrm
 {
@@ -11,27 +12,21 @@ namespace storage
 struct SharedBarriers
 {
 
-    SharedBarriers()
-        : pending_update_mutex(boost::interprocess::open_or_create, "pending_update"),
-          update_mutex(boost::interprocess::open_or_create, "update"),
-          query_mutex(boost::interprocess::open_or_create, "query"),
-          no_running_queries_condition(boost::interprocess::open_or_create, "no_running_queries"),
-          update_ongoing(false), number_of_queries(0)
+    // every dataset is updated independently of the others
+    explicit SharedBarriers(const std::string &dataset_name = "")
+        : pending_update_mutex(boost::interprocess::open_or_create,
+                               MutexName("pending_update", dataset_name).c_str())
     {
     }
 
-    // Mutex to protect access to the boolean variable
-    boost::interprocess::named_mutex pending_update_mutex;
-    boost::interprocess::named_mutex update_mutex;
-    boost::interprocess::named_mutex query_mutex;
-
-    // Condition that no update is running
-    boost::interprocess::named_condition no_running_queries_condition;
+    static std::string MutexName(const std::string &name, const std::string &dataset_name)
+    {
+        return dataset_name.empty() ? name : name + "-" + dataset_name;
+    }
 
-    // Is there an ongoing update?
-    bool update_ongoing;
-    // Is there any query?
-    int number_of_queries;
+    // Serialize updates of the shared memory regions. Queries take no lock, the engine
+    // retires an old dataset only after its queries are done (see engine::DatasetEpochs).
+    boost::interprocess::named_mutex pending_update_mutex;
 };
 }
 }
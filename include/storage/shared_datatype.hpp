@@ -42,13 +42,50 @@ struct SharedDataLayout
         DATASOURCE_NAME_OFFSETS,
         DATASOURCE_NAME_LENGTHS,
         PROPERTIES,
+        // COORDINATE_LIST and GEOMETRIES_LIST as util::PackedPairList, the plain blocks are empty
+        PACKED_COORDINATE_LIST,
+        PACKED_GEOMETRIES_LIST,
         NUM_BLOCKS
     };
 
+    static const char *GetBlockName(const BlockID bid)
+    {
+        static const char *const block_names[NUM_BLOCKS] = {"NAME_OFFSETS",
+                                                             "NAME_BLOCKS",
+                                                             "NAME_CHAR_LIST",
+                                                             "NAME_ID_LIST",
+                                                             "VIA_NODE_LIST",
+                                                             "GRAPH_NODE_LIST",
+                                                             "GRAPH_EDGE_LIST",
+                                                             "COORDINATE_LIST",
+                                                             "TURN_INSTRUCTION",
+                                                             "TRAVEL_MODE",
+                                                             "R_SEARCH_TREE",
+                                                             "GEOMETRIES_INDEX",
+                                                             "GEOMETRIES_LIST",
+                                                             "HSGR_CHECKSUM",
+                                                             "TIMESTAMP",
+                                                             "FILE_INDEX_PATH",
+                                                             "CORE_MARKER",
+                                                             "DATASOURCES_LIST",
+                                                             "DATASOURCE_NAME_DATA",
+                                                             "DATASOURCE_NAME_OFFSETS",
+                                                             "DATASOURCE_NAME_LENGTHS",
+                                                             "PROPERTIES",
+                                                             "PACKED_COORDINATE_LIST",
+                                                             "PACKED_GEOMETRIES_LIST"};
+        return block_names[bid];
+    }
+
     std::array<uint64_t, NUM_BLOCKS> num_entries;
     std::array<uint64_t, NUM_BLOCKS> entry_size;
+    // every block starts at a multiple of this, e.g. the huge page size
+    uint64_t block_alignment;
+    // Blocks smaller than block_alignment would mostly be padding, they are aligned to at most
+    // a normal page instead.
+    static constexpr const uint64_t SMALL_BLOCK_ALIGNMENT = 4096;
 
-    SharedDataLayout() : num_entries(), entry_size() {}
+    SharedDataLayout() : num_entries(), entry_size(), block_alignment(1) {}
 
     template <typename T> inline void SetBlockSize(BlockID bid, uint64_t entries)
     {
@@ -77,13 +114,24 @@ struct SharedDataLayout
         uint64_t result = sizeof(CANARY);
         for (auto i = 0; i < bid; i++)
         {
-            result += GetBlockSize((BlockID)i) + 2 * sizeof(CANARY);
+            result = AlignBlockOffset((BlockID)i, result) + GetBlockSize((BlockID)i) +
+                     2 * sizeof(CANARY);
         }
-        return result;
+        return bid < NUM_BLOCKS ? AlignBlockOffset(bid, result) : result;
+    }
+
+    // the start canary stays right in front of the block, padding goes in front of it
+    inline uint64_t AlignBlockOffset(const BlockID bid, const uint64_t offset) const
+    {
+        const uint64_t alignment =
+            GetBlockSize(bid) < block_alignment && block_alignment > SMALL_BLOCK_ALIGNMENT
+                ? SMALL_BLOCK_ALIGNMENT
+                : block_alignment;
+        return (offset + alignment - 1) / alignment * alignment;
     }
 
     template <typename T, bool WRITE_CANARY = false>
-    inline T *GetBlockPtr(char *shared_memory, BlockID bid)
+    inline T *GetBlockPtr(char *shared_memory, BlockID bid) const
     {
         T *ptr = (T *)(shared_memory + GetBlockOffset(bid));
         if (WRITE_CANARY)
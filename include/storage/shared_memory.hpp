@@ -18,25 +18,46 @@
 #include <sys/shm.h>
 #endif
 
-// #include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 #include <algorithm>
 #include <exception>
+#include <fstream>
+#include <string>
 
 namespace osrm
 {
 namespace storage
 {
 
+// Dataset names end up in file and mutex names and in URLs, like profiles they are alphanumeric
+inline bool IsValidDatasetName(const std::string &dataset_name)
+{
+    return std::all_of(dataset_name.begin(), dataset_name.end(), [](const char c) {
+        return std::isalnum(static_cast<unsigned char>(c));
+    });
+}
+
+// The keys of the shared memory regions are derived from this file, so every dataset
+// has a lock file of its own. The unnamed dataset keeps the original file.
 struct OSRMLockFile
 {
+    explicit OSRMLockFile(const std::string &dataset_name = "") : dataset_name(dataset_name) {}
+
     boost::filesystem::path operator()()
     {
         boost::filesystem::path temp_dir = boost::filesystem::temp_directory_path();
-        boost::filesystem::path lock_file = temp_dir / "osrm.lock";
+        boost::filesystem::path lock_file =
+            temp_dir / (dataset_name.empty() ? "osrm.lock" : "osrm-" + dataset_name + ".lock");
         return lock_file;
     }
+
+    std::string dataset_name;
 };
 
 #ifndef WIN32
@@ -78,6 +99,9 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
+    // False if huge pages were requested, but the region fell back to normal pages
+    bool UsesHugePages() const { return huge_pages; }
+
     SharedMemory(const SharedMemory &) = delete;
     SharedMemory &operator=(const SharedMemory &) = delete;
 
@@ -86,8 +110,9 @@ class SharedMemory
                  const IdentifierT id,
                  const uint64_t size = 0,
                  bool read_write = false,
-                 bool remove_prev = true)
-        : key(lock_file.string().c_str(), id)
+                 bool remove_prev = true,
+                 bool use_huge_pages = false)
+        : key(lock_file.string().c_str(), id), huge_pages(false)
     {
         if (0 == size)
         { // read_only
@@ -104,6 +129,28 @@ class SharedMemory
             {
                 Remove(key);
             }
+#ifdef __linux__
+            if (use_huge_pages)
+            {
+                // xsi_shared_memory can't pass SHM_HUGETLB, so create the segment here and
+                // let it open the existing segment below
+                const uint64_t huge_page_size = GetHugePageSize();
+                const uint64_t rounded_size =
+                    (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+                if (-1 == shmget(key.get_key(), rounded_size, IPC_CREAT | SHM_HUGETLB | 0644))
+                {
+                    util::SimpleLogger().Write(logWARNING)
+                        << "could not allocate " << rounded_size << " bytes of huge pages ("
+                        << std::strerror(errno) << "), using normal pages";
+                }
+                else
+                {
+                    huge_pages = true;
+                }
+            }
+#else
+            (void)use_huge_pages;
+#endif
             shm = boost::interprocess::xsi_shared_memory(boost::interprocess::open_or_create, key,
                                                          size);
 #ifdef __linux__
@@ -123,12 +170,13 @@ class SharedMemory
         }
     }
 
-    template <typename IdentifierT> static bool RegionExists(const IdentifierT id)
+    template <typename IdentifierT>
+    static bool RegionExists(const IdentifierT id, const std::string &dataset_name = "")
     {
         bool result = true;
         try
         {
-            OSRMLockFile lock_file;
+            OSRMLockFile lock_file(dataset_name);
             boost::interprocess::xsi_key key(lock_file().string().c_str(), id);
             result = RegionExists(key);
         }
@@ -139,13 +187,32 @@ class SharedMemory
         return result;
     }
 
-    template <typename IdentifierT> static bool Remove(const IdentifierT id)
+    template <typename IdentifierT>
+    static bool Remove(const IdentifierT id, const std::string &dataset_name = "")
     {
-        OSRMLockFile lock_file;
+        OSRMLockFile lock_file(dataset_name);
         boost::interprocess::xsi_key key(lock_file().string().c_str(), id);
         return Remove(key);
     }
 
+    // Size of the default huge pages in bytes, 0 if there are none
+    static uint64_t GetHugePageSize()
+    {
+#ifdef __linux__
+        std::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line))
+        {
+            uint64_t size_in_kib = 0;
+            if (1 == std::sscanf(line.c_str(), "Hugepagesize: %" SCNu64 " kB", &size_in_kib))
+            {
+                return size_in_kib * 1024;
+            }
+        }
+#endif
+        return 0;
+    }
+
   private:
     static bool RegionExists(const boost::interprocess::xsi_key &key)
     {
@@ -181,6 +248,7 @@ class SharedMemory
     }
 
     boost::interprocess::xsi_key key;
+    bool huge_pages;
     boost::interprocess::xsi_shared_memory shm;
     boost::interprocess::mapped_region region;
     shm_remove remover;
@@ -226,13 +294,16 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
+    bool UsesHugePages() const { return false; }
+
     SharedMemory(const boost::filesystem::path &lock_file,
                  const int id,
                  const uint64_t size = 0,
                  bool read_write = false,
-                 bool remove_prev = true)
+                 bool remove_prev = true,
+                 bool /* use_huge_pages */ = false)
     {
-        sprintf(key, "%s.%d", "osrm.lock", id);
+        sprintf(key, "%s.%d", lock_file.filename().string().c_str(), id);
         if (0 == size)
         { // read_only
             shm = boost::interprocess::shared_memory_object(
@@ -259,13 +330,13 @@ class SharedMemory
         }
     }
 
-    static bool RegionExists(const int id)
+    static bool RegionExists(const int id, const std::string &dataset_name = "")
     {
         bool result = true;
         try
         {
             char k[500];
-            build_key(id, k);
+            build_key(id, dataset_name, k);
             result = RegionExists(k);
         }
         catch (...)
@@ -275,15 +346,21 @@ class SharedMemory
         return result;
     }
 
-    static bool Remove(const int id)
+    static bool Remove(const int id, const std::string &dataset_name = "")
     {
         char k[500];
-        build_key(id, k);
+        build_key(id, dataset_name, k);
         return Remove(k);
     }
 
+    // Huge pages need special privileges on Windows and aren't supported
+    static uint64_t GetHugePageSize() { return 0; }
+
   private:
-    static void build_key(int id, char *key) { sprintf(key, "%s.%d", "osrm.lock", id); }
+    static void build_key(int id, const std::string &dataset_name, char *key)
+    {
+        sprintf(key, "%s.%d", OSRMLockFile(dataset_name)().filename().string().c_str(), id);
+    }
 
     static bool RegionExists(const char *key)
     {
@@ -329,11 +406,13 @@ template <typename IdentifierT, typename LockFileT = OSRMLockFile>
 SharedMemory *makeSharedMemory(const IdentifierT &id,
                                const uint64_t size = 0,
                                bool read_write = false,
-                               bool remove_prev = true)
+                               bool remove_prev = true,
+                               bool use_huge_pages = false,
+                               const std::string &dataset_name = "")
 {
     try
     {
-        LockFileT lock_file;
+        LockFileT lock_file(dataset_name);
         if (!boost::filesystem::exists(lock_file()))
         {
             if (0 == size)
@@ -345,7 +424,7 @@ SharedMemory *makeSharedMemory(const IdentifierT &id,
                 boost::filesystem::ofstream ofs(lock_file());
             }
         }
-        return new SharedMemory(lock_file(), id, size, read_write, remove_prev);
+        return new SharedMemory(lock_file(), id, size, read_write, remove_prev, use_huge_pages);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
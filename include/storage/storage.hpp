@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define STORAGE_HPP
 
 #include "storage/storage_config.hpp"
+#include "util/packed_pair_list.hpp"
 
 #include <boost/filesystem/path.hpp>
 
@@ -38,14 +39,40 @@ namespace osrm
 {
 namespace storage
 {
+class DatasetContainer;
+struct SharedDataLayout;
+
 class Storage
 {
   public:
-    Storage(StorageConfig config);
+    Storage(StorageConfig config,
+            const bool use_huge_pages = false,
+            std::string dataset_name = "",
+            const bool compress_geometries = false);
+    // Loads the dataset into shared memory and points the readers to it
     int Run();
+    // Writes the dataset into a single container file instead
+    int WriteContainer(const boost::filesystem::path &container_path);
+    // Logs how much of every block is in memory, for a container or for shared memory
+    int ReportResidentSize();
 
   private:
+    void PopulateLayout(SharedDataLayout &layout);
+    void PackGeometries(SharedDataLayout &layout);
+    void PopulateData(const SharedDataLayout &layout, char *memory_ptr);
+    void CopyContainer(const DatasetContainer &container,
+                       const SharedDataLayout &layout,
+                       char *memory_ptr);
+
     StorageConfig config;
+    // back the data region with huge pages and align its blocks to them
+    bool use_huge_pages;
+    // datasets of different names live in shared memory side by side, empty is the default one
+    std::string dataset_name;
+    // store coordinates and geometries as util::PackedPairList, which PopulateLayout encodes
+    bool compress_geometries;
+    util::PackedPairListBuilder packed_coordinates;
+    util::PackedPairListBuilder packed_geometries;
 };
 }
 }
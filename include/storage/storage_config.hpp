@@ -48,6 +48,7 @@ struct StorageConfig final
      * Constructs a storage configuration setting paths based on a base path.
      *
      * \param base The base path (e.g. france.pbf.osrm) to derive auxiliary file suffixes from.
+     *             A path to a dataset container (e.g. france.osrm.dataset) is used as it is.
      */
     StorageConfig(const boost::filesystem::path &base);
     bool IsValid() const;
@@ -64,6 +65,8 @@ struct StorageConfig final
     boost::filesystem::path datasource_indexes_path;
     boost::filesystem::path names_data_path;
     boost::filesystem::path properties_path;
+    // single file holding all of the above but the .fileIndex, empty if the files are used
+    boost::filesystem::path dataset_path;
 };
 }
 }
@@ -7,11 +7,14 @@
 
 #include <boost/crc.hpp> // for boost::crc_32_type
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 
 namespace osrm
 {
-namespace contractor
+namespace util
 {
 
 class IteratorbasedCRC32
@@ -107,6 +110,73 @@ class IteratorbasedCRC32
     bool use_hardware_implementation;
 };
 
+// Computes a CRC32C checksum incrementally over consecutive buffers. Uses the SSE4.2 crc32
+// instruction on eight bytes at a time if the CPU supports it, which is fast enough to
+// checksum data on the fly while it is written.
+class BlockCRC32
+{
+  public:
+    BlockCRC32() : crc(0) { use_hardware_implementation = detect_hardware_support(); }
+
+    bool using_hardware() const { return use_hardware_implementation; }
+
+    void process(const char *data, std::size_t length)
+    {
+        if (use_hardware_implementation)
+        {
+            compute_in_hardware(data, length);
+        }
+        else
+        {
+            crc_processor.process_bytes(data, length);
+            crc = crc_processor.checksum();
+        }
+    }
+
+    unsigned checksum() const { return crc; }
+
+  private:
+    bool detect_hardware_support() const
+    {
+#if defined(__x86_64__) && !defined(__MINGW64__)
+        static const unsigned sse42_bit = 0x00100000;
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+        return (ecx & sse42_bit) != 0;
+#else
+        return false;
+#endif
+    }
+
+    void compute_in_hardware(const char *data, std::size_t length)
+    {
+#if defined(__x86_64__)
+        std::uint64_t crc64 = crc;
+        for (; length >= sizeof(std::uint64_t); length -= sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            __asm__("crc32q %1, %0" : "+r"(crc64) : "rm"(word));
+            data += sizeof(word);
+        }
+        std::uint32_t crc32 = static_cast<std::uint32_t>(crc64);
+        for (; length > 0; --length)
+        {
+            __asm__("crc32b %1, %0" : "+r"(crc32) : "rm"(*data));
+            ++data;
+        }
+        crc = crc32;
+#else
+        static_cast<void>(data);
+        static_cast<void>(length);
+#endif
+    }
+
+    boost::crc_optimal<32, 0x1EDC6F41, 0x0, 0x0, true, true> crc_processor;
+    unsigned crc;
+    bool use_hardware_implementation;
+};
+
 struct RangebasedCRC32
 {
     template <typename Iteratable> unsigned operator()(const Iteratable &iterable)
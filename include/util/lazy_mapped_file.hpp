@@ -0,0 +1,96 @@
+#ifndef LAZY_MAPPED_FILE_HPP
+#define LAZY_MAPPED_FILE_HPP
+
+#include "util/exception.hpp"
+#include "util/process_memory.hpp"
+#include "util/shared_memory_vector_wrapper.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * A file that is mapped read-only the first time its contents are used.
+ *
+ * Only the pages that are read are loaded from disk, and the kernel is free to drop them
+ * again under memory pressure. Data that few queries need, e.g. the street names, thus
+ * costs next to nothing until it is used.
+ */
+class LazyMappedFile
+{
+  public:
+    explicit LazyMappedFile(boost::filesystem::path path_)
+        : path(std::move(path_)), data(nullptr), size(0), is_mapped(false)
+    {
+    }
+
+    LazyMappedFile(const LazyMappedFile &) = delete;
+    LazyMappedFile &operator=(const LazyMappedFile &) = delete;
+
+    // Start of the file, maps it on the first call. Safe to call from concurrent queries.
+    char *GetData() const
+    {
+        std::call_once(mapped, [this] {
+            Map();
+        });
+        return data;
+    }
+
+    // View on count entries starting at offset bytes into the file
+    template <typename T>
+    typename ShM<T, true>::vector GetView(const std::size_t offset, const std::size_t count) const
+    {
+        if (0 == count)
+        {
+            return {};
+        }
+        return {reinterpret_cast<T *>(GetData() + offset), count};
+    }
+
+    // Bytes of the file in memory, 0 as long as it isn't mapped
+    std::size_t GetResidentSize() const
+    {
+        return is_mapped.load() ? getResidentSize(data, size) : 0;
+    }
+
+    const boost::filesystem::path &GetPath() const { return path; }
+
+  private:
+    void Map() const
+    {
+        try
+        {
+            file = boost::interprocess::file_mapping(path.string().c_str(),
+                                                     boost::interprocess::read_only);
+            region = boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+        }
+        catch (const boost::interprocess::interprocess_exception &e)
+        {
+            throw exception("Could not map " + path.string() + ": " + e.what());
+        }
+        data = static_cast<char *>(region.get_address());
+        size = region.get_size();
+        is_mapped.store(true);
+    }
+
+    boost::filesystem::path path;
+    mutable std::once_flag mapped;
+    mutable boost::interprocess::file_mapping file;
+    mutable boost::interprocess::mapped_region region;
+    mutable char *data;
+    mutable std::size_t size;
+    mutable std::atomic<bool> is_mapped;
+};
+}
+}
+
+#endif // LAZY_MAPPED_FILE_HPP
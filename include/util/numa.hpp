@@ -0,0 +1,151 @@
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * NUMA nodes of this machine and the CPUs they consist of, read from sysfs.
+ * Node ids in sysfs can have gaps, the nodes here are numbered 0..NumberOfNodes()-1
+ * in the order of their ids.
+ *
+ * Without NUMA support, or off Linux, there is a single node and threads are
+ * never bound. Memory follows the first-touch policy of the kernel, so data a
+ * bound thread allocates and writes ends up on the node of that thread.
+ */
+class NumaTopology
+{
+  public:
+#ifdef __linux__
+    NumaTopology() : NumaTopology("/sys/devices/system/node") {}
+#else
+    NumaTopology() : node_cpus(1) {}
+#endif
+
+    // Reads the topology from a directory laid out like /sys/devices/system/node
+    explicit NumaTopology(const boost::filesystem::path &node_root)
+    {
+        // lists the ids of all nodes, in the same format as the CPUs of a node
+        boost::filesystem::ifstream online_stream(node_root / "online");
+        std::string online;
+        std::getline(online_stream, online);
+        for (const auto node_id : ParseCPUList(online))
+        {
+            boost::filesystem::ifstream cpu_list_stream(
+                node_root / ("node" + std::to_string(node_id)) / "cpulist");
+            std::string cpu_list;
+            std::getline(cpu_list_stream, cpu_list);
+            const auto node = static_cast<unsigned>(node_cpus.size());
+            node_cpus.push_back(ParseCPUList(cpu_list));
+            for (const auto cpu : node_cpus.back())
+            {
+                if (cpu >= cpu_to_node.size())
+                {
+                    cpu_to_node.resize(cpu + 1, 0);
+                }
+                cpu_to_node[cpu] = node;
+            }
+        }
+        if (node_cpus.empty())
+        {
+            node_cpus.emplace_back();
+        }
+    }
+
+    unsigned NumberOfNodes() const { return static_cast<unsigned>(node_cpus.size()); }
+
+    // Node of every CPU, indexed by CPU number
+    const std::vector<unsigned> &CPUToNode() const { return cpu_to_node; }
+
+    // Node of the CPU the calling thread currently runs on
+    unsigned CurrentNode() const
+    {
+        const int cpu = CurrentCPU();
+        if (cpu >= 0 && static_cast<unsigned>(cpu) < cpu_to_node.size())
+        {
+            return cpu_to_node[cpu];
+        }
+        return 0;
+    }
+
+    // CPU the calling thread currently runs on, -1 if unknown
+    static int CurrentCPU()
+    {
+#ifdef __linux__
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    // Restricts the calling thread to the CPUs of a node, returns false if that's not possible
+    bool BindCurrentThread(const unsigned node) const
+    {
+#ifdef __linux__
+        if (node >= node_cpus.size() || node_cpus[node].empty())
+        {
+            return false;
+        }
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (const auto cpu : node_cpus[node])
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+        return 0 == pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#else
+        (void)node;
+        return false;
+#endif
+    }
+
+    // Parses lists like "0-7,16-23"
+    static std::vector<unsigned> ParseCPUList(const std::string &cpu_list)
+    {
+        std::vector<unsigned> cpus;
+        std::istringstream stream(cpu_list);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            const auto dash = range.find('-');
+            try
+            {
+                const unsigned first = std::stoul(range.substr(0, dash));
+                const unsigned last =
+                    dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+                for (unsigned cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            catch (const std::logic_error &)
+            {
+                // empty or malformed entry, e.g. a memory-only node
+            }
+        }
+        return cpus;
+    }
+
+  private:
+    std::vector<std::vector<unsigned>> node_cpus;
+    std::vector<unsigned> cpu_to_node;
+};
+}
+}
+
+#endif // NUMA_HPP
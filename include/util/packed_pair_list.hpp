@@ -0,0 +1,198 @@
+#ifndef PACKED_PAIR_LIST_HPP
+#define PACKED_PAIR_LIST_HPP
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Pairs of 32 bit integers, e.g. coordinates, packed into a byte buffer.
+ *
+ * The pairs are grouped into blocks of BLOCK_SIZE. A block starts with its first pair, every
+ * other pair is stored as the difference to its predecessor. All values are zigzag encoded
+ * varints, so values close to their predecessor take one or two bytes instead of four.
+ * Reading a pair decodes at most one block, found through an index of the block offsets.
+ *
+ * The buffer holds the number of pairs, the offsets of the blocks and of the end of the data,
+ * all as std::uint64_t, followed by the blocks. It can start at any address.
+ */
+class PackedPairList
+{
+  public:
+    using Pair = std::pair<std::int32_t, std::int32_t>;
+    static constexpr const std::size_t BLOCK_SIZE = 16;
+
+    PackedPairList() : buffer(nullptr), number_of_pairs(0) {}
+
+    explicit PackedPairList(const char *buffer_)
+        : buffer(buffer_), number_of_pairs(ReadUInt64(buffer_))
+    {
+    }
+
+    std::size_t size() const { return number_of_pairs; }
+
+    bool empty() const { return 0 == number_of_pairs; }
+
+    Pair at(const std::size_t index) const
+    {
+        BOOST_ASSERT(index < number_of_pairs);
+        Pair result;
+        ForEach(index, index + 1, [&result](const Pair &pair) {
+            result = pair;
+        });
+        return result;
+    }
+
+    // Calls callback with every pair in [begin, end), in order
+    template <typename CallbackT>
+    void ForEach(const std::size_t begin, const std::size_t end, CallbackT &&callback) const
+    {
+        BOOST_ASSERT(begin <= end && end <= number_of_pairs);
+        if (begin == end)
+        {
+            return;
+        }
+
+        std::size_t index = begin / BLOCK_SIZE * BLOCK_SIZE;
+        const auto number_of_blocks = (number_of_pairs + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto *position = reinterpret_cast<const unsigned char *>(
+            buffer + (number_of_blocks + 2) * sizeof(std::uint64_t) +
+            ReadUInt64(buffer + (index / BLOCK_SIZE + 1) * sizeof(std::uint64_t)));
+
+        std::uint32_t first = 0;
+        std::uint32_t second = 0;
+        for (; index < end; ++index)
+        {
+            if (0 == index % BLOCK_SIZE)
+            {
+                first = DecodeZigZag(position);
+                second = DecodeZigZag(position);
+            }
+            else
+            {
+                // unsigned arithmetic wraps around like the encoder's did
+                first += DecodeZigZag(position);
+                second += DecodeZigZag(position);
+            }
+            if (index >= begin)
+            {
+                callback(Pair(static_cast<std::int32_t>(first), static_cast<std::int32_t>(second)));
+            }
+        }
+    }
+
+  private:
+    static std::uint64_t ReadUInt64(const char *position)
+    {
+        std::uint64_t value;
+        std::memcpy(&value, position, sizeof(value));
+        return value;
+    }
+
+    static std::uint32_t DecodeZigZag(const unsigned char *&position)
+    {
+        std::uint32_t value = 0;
+        for (unsigned shift = 0;; shift += 7)
+        {
+            const unsigned char byte = *position++;
+            value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+            if (0 == (byte & 0x80))
+            {
+                break;
+            }
+        }
+        return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
+    const char *buffer;
+    std::size_t number_of_pairs;
+};
+
+// Packs pairs one after the other into the buffer of a PackedPairList
+class PackedPairListBuilder
+{
+  public:
+    PackedPairListBuilder() : number_of_pairs(0), previous_first(0), previous_second(0) {}
+
+    void Add(const std::int32_t first, const std::int32_t second)
+    {
+        const auto unsigned_first = static_cast<std::uint32_t>(first);
+        const auto unsigned_second = static_cast<std::uint32_t>(second);
+        if (0 == number_of_pairs % PackedPairList::BLOCK_SIZE)
+        {
+            block_offsets.push_back(data.size());
+            EncodeZigZag(unsigned_first);
+            EncodeZigZag(unsigned_second);
+        }
+        else
+        {
+            EncodeZigZag(unsigned_first - previous_first);
+            EncodeZigZag(unsigned_second - previous_second);
+        }
+        previous_first = unsigned_first;
+        previous_second = unsigned_second;
+        ++number_of_pairs;
+    }
+
+    std::size_t size() const { return number_of_pairs; }
+
+    // Size of the buffer in bytes
+    std::size_t GetBufferSize() const
+    {
+        return (block_offsets.size() + 2) * sizeof(std::uint64_t) + data.size();
+    }
+
+    // Writes GetBufferSize() bytes to buffer
+    void Write(char *buffer) const
+    {
+        const std::uint64_t header[] = {number_of_pairs};
+        std::memcpy(buffer, header, sizeof(header));
+        buffer += sizeof(header);
+        // data() of an empty vector may be a null pointer, which memcpy must not get
+        if (!block_offsets.empty())
+        {
+            std::memcpy(buffer, block_offsets.data(), block_offsets.size() * sizeof(std::uint64_t));
+        }
+        buffer += block_offsets.size() * sizeof(std::uint64_t);
+        const std::uint64_t end_offset = data.size();
+        std::memcpy(buffer, &end_offset, sizeof(end_offset));
+        buffer += sizeof(end_offset);
+        if (!data.empty())
+        {
+            std::memcpy(buffer, data.data(), data.size());
+        }
+    }
+
+  private:
+    void EncodeZigZag(const std::uint32_t value)
+    {
+        // moves the sign to the lowest bit, so small negative values stay small
+        std::uint32_t zigzag = (value << 1) ^ (0 - (value >> 31));
+        while (zigzag >= 0x80)
+        {
+            data.push_back(static_cast<unsigned char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        data.push_back(static_cast<unsigned char>(zigzag));
+    }
+
+    std::vector<std::uint64_t> block_offsets;
+    std::vector<unsigned char> data;
+    std::uint64_t number_of_pairs;
+    std::uint32_t previous_first;
+    std::uint32_t previous_second;
+};
+}
+}
+
+#endif // PACKED_PAIR_LIST_HPP
@@ -0,0 +1,89 @@
+#ifndef PROCESS_MEMORY_HPP
+#define PROCESS_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Returns the resident set size of the current process in bytes, or 0 if unknown.
+inline std::size_t getResidentSetSize()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total_pages = 0;
+    std::size_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages)
+    {
+        return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+// Returns how many bytes of the pages spanning [begin, begin + size) of a mapping are in
+// memory, or 0 if unknown. Pages of mapped files count if they are in the page cache.
+inline std::size_t getResidentSize(const void *begin, const std::size_t size)
+{
+#ifdef __linux__
+    if (0 == size)
+    {
+        return 0;
+    }
+    const auto page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto first = reinterpret_cast<std::uintptr_t>(begin) / page_size * page_size;
+    const auto last = reinterpret_cast<std::uintptr_t>(begin) + size;
+    std::vector<unsigned char> pages((last - first + page_size - 1) / page_size);
+    if (0 != mincore(reinterpret_cast<void *>(first), last - first, pages.data()))
+    {
+        return 0;
+    }
+    const auto resident_pages =
+        std::count_if(pages.begin(), pages.end(), [](const unsigned char page) {
+            return page & 1;
+        });
+    return std::min<std::size_t>(resident_pages * page_size, size);
+#else
+    (void)begin;
+    (void)size;
+    return 0;
+#endif
+}
+
+// Reads a byte of every page of [begin, begin + size), so that the pages are mapped and in
+// memory before anyone who cares about latency reads them
+inline void prefaultMemory(const void *begin, const std::size_t size)
+{
+#ifdef __linux__
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    const std::size_t page_size = 4096;
+#endif
+    const volatile char *bytes = static_cast<const volatile char *>(begin);
+    char checksum = 0;
+    for (std::size_t offset = 0; offset < size; offset += page_size)
+    {
+        checksum ^= bytes[offset];
+    }
+    if (size > 0)
+    {
+        checksum ^= bytes[size - 1];
+    }
+    (void)checksum;
+}
+}
+}
+
+#endif // PROCESS_MEMORY_HPP
@@ -73,6 +73,9 @@ class StaticRTree
     };
 
   private:
+    // number of leaves that are packed in parallel and written at once
+    static constexpr const std::uint32_t LEAF_CHUNK_SIZE = 256;
+
     struct WrappedInputElement
     {
         explicit WrappedInputElement(const uint64_t _hilbert_value,
@@ -158,72 +161,94 @@ class StaticRTree
 
         // sort the hilbert-value representatives
         tbb::parallel_sort(input_wrapper_vector.begin(), input_wrapper_vector.end());
-        std::vector<TreeNode> tree_nodes_in_level;
 
-        // pack M elements into leaf node and write to leaf file
-        uint64_t processed_objects_count = 0;
-        while (processed_objects_count < m_element_count)
+        // pack M elements into leaf node and write to leaf file. Leaves are packed and their
+        // tree nodes generated in parallel, one chunk of leaves at a time, and each chunk is
+        // written with a single write.
+        const uint64_t number_of_leaves = (m_element_count + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE;
+        std::vector<TreeNode> tree_nodes_in_level(number_of_leaves);
+        std::vector<LeafNode> leaf_chunk(std::min<uint64_t>(number_of_leaves, LEAF_CHUNK_SIZE));
+        for (uint64_t chunk_begin = 0; chunk_begin < number_of_leaves;
+             chunk_begin += LEAF_CHUNK_SIZE)
         {
+            const uint64_t chunk_end = std::min(number_of_leaves, chunk_begin + LEAF_CHUNK_SIZE);
+            tbb::parallel_for(
+                tbb::blocked_range<uint64_t>(chunk_begin, chunk_end),
+                [&](const tbb::blocked_range<uint64_t> &range) {
+                    for (uint64_t leaf_index = range.begin(), end = range.end();
+                         leaf_index != end; ++leaf_index)
+                    {
+                        LeafNode &current_leaf = leaf_chunk[leaf_index - chunk_begin];
+                        const uint64_t first_object = leaf_index * LEAF_NODE_SIZE;
+                        current_leaf.object_count = static_cast<std::uint32_t>(std::min<uint64_t>(
+                            LEAF_NODE_SIZE, m_element_count - first_object));
+                        for (std::uint32_t current_element_index = 0;
+                             current_element_index < current_leaf.object_count;
+                             ++current_element_index)
+                        {
+                            const std::uint32_t index_of_next_object =
+                                input_wrapper_vector[first_object + current_element_index]
+                                    .m_array_index;
+                            current_leaf.objects[current_element_index] =
+                                input_data_vector[index_of_next_object];
+                        }
+                        // only the last leaf is partially filled
+                        std::fill(current_leaf.objects.begin() + current_leaf.object_count,
+                                  current_leaf.objects.end(), EdgeDataT());
+
+                        // generate tree node that resemble the objects in leaf and store it for
+                        // next level
+                        TreeNode &current_node = tree_nodes_in_level[leaf_index];
+                        InitializeMBRectangle(current_node.minimum_bounding_rectangle,
+                                              current_leaf.objects, current_leaf.object_count,
+                                              coordinate_list);
+                        current_node.child_is_on_disk = true;
+                        current_node.children[0] = leaf_index;
+                    }
+                });
 
-            LeafNode current_leaf;
-            TreeNode current_node;
-            for (std::uint32_t current_element_index = 0; LEAF_NODE_SIZE > current_element_index;
-                 ++current_element_index)
-            {
-                if (m_element_count > (processed_objects_count + current_element_index))
-                {
-                    std::uint32_t index_of_next_object =
-                        input_wrapper_vector[processed_objects_count + current_element_index]
-                            .m_array_index;
-                    current_leaf.objects[current_element_index] =
-                        input_data_vector[index_of_next_object];
-                    ++current_leaf.object_count;
-                }
-            }
-
-            // generate tree node that resemble the objects in leaf and store it for next level
-            InitializeMBRectangle(current_node.minimum_bounding_rectangle, current_leaf.objects,
-                                  current_leaf.object_count, coordinate_list);
-            current_node.child_is_on_disk = true;
-            current_node.children[0] = tree_nodes_in_level.size();
-            tree_nodes_in_level.emplace_back(current_node);
-
-            // write leaf_node to leaf node file
-            leaf_node_file.write((char *)&current_leaf, sizeof(current_leaf));
-            processed_objects_count += current_leaf.object_count;
+            // write leaf_nodes to leaf node file
+            leaf_node_file.write((char *)leaf_chunk.data(),
+                                 sizeof(LeafNode) * (chunk_end - chunk_begin));
         }
 
-        std::uint32_t processing_level = 0;
+        // build the upper levels bottom-up. Each level is appended to the search tree as a
+        // whole and the parents of a level are packed in parallel.
         while (1 < tree_nodes_in_level.size())
         {
-            std::vector<TreeNode> tree_nodes_in_next_level;
-            std::uint32_t processed_tree_nodes_in_level = 0;
-            while (processed_tree_nodes_in_level < tree_nodes_in_level.size())
-            {
-                TreeNode parent_node;
-                // pack BRANCHING_FACTOR elements into tree_nodes each
-                for (std::uint32_t current_child_node_index = 0;
-                     BRANCHING_FACTOR > current_child_node_index; ++current_child_node_index)
-                {
-                    if (processed_tree_nodes_in_level < tree_nodes_in_level.size())
+            const std::uint32_t level_offset = m_search_tree.size();
+            const std::uint32_t level_size = tree_nodes_in_level.size();
+            m_search_tree.resize(level_offset + level_size);
+
+            std::vector<TreeNode> tree_nodes_in_next_level((level_size + BRANCHING_FACTOR - 1) /
+                                                           BRANCHING_FACTOR);
+            tbb::parallel_for(
+                tbb::blocked_range<std::uint32_t>(0, tree_nodes_in_next_level.size()),
+                [&](const tbb::blocked_range<std::uint32_t> &range) {
+                    for (std::uint32_t parent_index = range.begin(), end = range.end();
+                         parent_index != end; ++parent_index)
                     {
-                        TreeNode &current_child_node =
-                            tree_nodes_in_level[processed_tree_nodes_in_level];
-                        // add tree node to parent entry
-                        parent_node.children[current_child_node_index] = m_search_tree.size();
-                        m_search_tree.emplace_back(current_child_node);
-                        // merge MBRs
-                        parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                            current_child_node.minimum_bounding_rectangle);
-                        // increase counters
-                        ++parent_node.child_count;
-                        ++processed_tree_nodes_in_level;
+                        TreeNode &parent_node = tree_nodes_in_next_level[parent_index];
+                        const std::uint32_t first_child = parent_index * BRANCHING_FACTOR;
+                        const std::uint32_t last_child =
+                            std::min(level_size, first_child + BRANCHING_FACTOR);
+                        // pack BRANCHING_FACTOR elements into tree_nodes each
+                        for (std::uint32_t child_index = first_child; child_index < last_child;
+                             ++child_index)
+                        {
+                            const TreeNode &current_child_node = tree_nodes_in_level[child_index];
+                            // add tree node to parent entry
+                            parent_node.children[parent_node.child_count] =
+                                level_offset + child_index;
+                            m_search_tree[level_offset + child_index] = current_child_node;
+                            // merge MBRs
+                            parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                                current_child_node.minimum_bounding_rectangle);
+                            ++parent_node.child_count;
+                        }
                     }
-                }
-                tree_nodes_in_next_level.emplace_back(parent_node);
-            }
+                });
             tree_nodes_in_level.swap(tree_nodes_in_next_level);
-            ++processing_level;
         }
         BOOST_ASSERT_MSG(1 == tree_nodes_in_level.size(), "tree broken, more than one root node");
         // last remaining entry is the root node, store it
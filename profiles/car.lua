@@ -154,6 +154,22 @@ function get_exceptions(vector)
   end
 end
 
+-- tag keys read by node_function and way_function, entities without any
+-- of them are not passed to the profile
+function get_node_tag_keys(vector)
+  for i,v in ipairs(access_tags_hierarchy) do
+    vector:Add(v)
+  end
+  vector:Add("barrier")
+  vector:Add("highway")
+end
+
+function get_way_tag_keys(vector)
+  vector:Add("highway")
+  vector:Add("route")
+  vector:Add("bridge")
+end
+
 local function parse_maxspeed(source)
   if not source then
     return 0
@@ -1,10 +1,11 @@
 #include "contractor/contractor.hpp"
-#include "contractor/crc32_processor.hpp"
 #include "contractor/graph_contractor.hpp"
+#include "contractor/nested_dissection.hpp"
 
 #include "extractor/node_based_edge.hpp"
 #include "extractor/compressed_edge_container.hpp"
 
+#include "util/crc32_processor.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/graph_loader.hpp"
@@ -21,6 +22,9 @@
 #include <boost/assert.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 #include <tbb/parallel_sort.h>
 
 #include <cstdint>
@@ -29,6 +33,7 @@
 #include <memory>
 #include <thread>
 #include <iterator>
+#include <tuple>
 
 namespace std
 {
@@ -65,52 +70,96 @@ int Contractor::Run()
 
     TIMER_START(preparing);
 
-    util::SimpleLogger().Write() << "Loading edge-expanded graph representation";
-
     util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edge_list;
+    std::size_t max_edge_id = SPECIAL_EDGEID;
+
+    // A resumed run has already updated the geometry and loaded the graph before the checkpoint
+    if (!config.resume_from_checkpoint)
+    {
+        util::SimpleLogger().Write() << "Loading edge-expanded graph representation";
 
-    std::size_t max_edge_id = LoadEdgeExpandedGraph(
-        config.edge_based_graph_path, edge_based_edge_list, config.edge_segment_lookup_path,
-        config.edge_penalty_path, config.segment_speed_lookup_paths, config.node_based_graph_path,
-        config.geometry_path, config.datasource_names_path, config.datasource_indexes_path,
-        config.rtree_leaf_path);
+        max_edge_id = LoadEdgeExpandedGraph(
+            config.edge_based_graph_path, edge_based_edge_list, config.edge_segment_lookup_path,
+            config.edge_penalty_path, config.segment_speed_lookup_paths,
+            config.node_based_graph_path, config.geometry_path, config.datasource_names_path,
+            config.datasource_indexes_path, config.rtree_leaf_path);
+    }
 
     // Contracting the edge-expanded graph
 
     TIMER_START(contraction);
     std::vector<bool> is_core_node;
     std::vector<float> node_levels;
-    if (config.use_cached_priority)
-    {
-        ReadNodeLevels(node_levels);
-    }
-
-    util::SimpleLogger().Write() << "Reading node weights.";
-    std::vector<EdgeWeight> node_weights;
-    std::string node_file_name = config.osrm_input_path.string() + ".enw";
-    if (util::deserializeVector(node_file_name, node_weights))
+    // cached and nested dissection levels are in the .level file already
+    bool computed_node_levels = !config.use_cached_priority && !config.use_nested_dissection;
+    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    if (config.resume_from_checkpoint)
     {
-        util::SimpleLogger().Write() << "Done reading node weights.";
+        // the interrupted run decides, not the flags of this one
+        max_edge_id = ResumeContractGraph(contracted_edge_list, is_core_node, node_levels,
+                                          computed_node_levels);
     }
     else
     {
-        throw util::exception("Failed reading node weights.");
-    }
+        if (config.use_cached_priority)
+        {
+            ReadNodeLevels(node_levels);
+        }
+        else if (config.use_nested_dissection)
+        {
+            util::SimpleLogger().Write() << "Computing nested dissection order";
+            TIMER_START(dissection);
+            NestedDissection dissection(max_edge_id + 1, edge_based_edge_list);
+            node_levels = dissection.ComputeNodeLevels();
+            TIMER_STOP(dissection);
+            util::SimpleLogger().Write() << "Nested dissection took " << TIMER_SEC(dissection)
+                                         << " sec";
+            // the contractor consumes the levels, keep them for later --level-cache runs
+            WriteNodeLevels(std::vector<float>(node_levels));
+        }
 
-    util::DeallocatingVector<QueryEdge> contracted_edge_list;
-    ContractGraph(max_edge_id, edge_based_edge_list, contracted_edge_list, std::move(node_weights),
-                  is_core_node, node_levels);
+        util::SimpleLogger().Write() << "Reading node weights.";
+        std::vector<EdgeWeight> node_weights;
+        std::string node_file_name = config.osrm_input_path.string() + ".enw";
+        if (util::deserializeVector(node_file_name, node_weights))
+        {
+            util::SimpleLogger().Write() << "Done reading node weights.";
+        }
+        else
+        {
+            throw util::exception("Failed reading node weights.");
+        }
+
+        if (config.update_core_only)
+        {
+            RecontractCore(max_edge_id, edge_based_edge_list, contracted_edge_list,
+                           std::move(node_weights), is_core_node, node_levels);
+            // the recontracted core has new levels, the .level file has to match the .hsgr
+            computed_node_levels = true;
+        }
+        else
+        {
+            ContractGraph(max_edge_id, edge_based_edge_list, contracted_edge_list,
+                          std::move(node_weights), is_core_node, node_levels);
+        }
+    }
     TIMER_STOP(contraction);
 
     util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
     std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
     WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
+    if (computed_node_levels)
     {
         WriteNodeLevels(std::move(node_levels));
     }
 
+    // the output is complete, a checkpoint would only resume a finished run
+    if (boost::filesystem::exists(config.checkpoint_path))
+    {
+        boost::filesystem::remove(config.checkpoint_path);
+    }
+
     TIMER_STOP(preparing);
 
     util::SimpleLogger().Write() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
@@ -514,6 +563,28 @@ void Contractor::ReadNodeLevels(std::vector<float> &node_levels) const
     order_input_stream.read((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
+void Contractor::ReadCoreNodeMarker(std::vector<bool> &is_core_node) const
+{
+    boost::filesystem::ifstream core_marker_input_stream(config.core_output_path,
+                                                         std::ios::binary);
+    if (!core_marker_input_stream)
+    {
+        is_core_node.clear();
+        return;
+    }
+
+    unsigned size = 0;
+    core_marker_input_stream.read((char *)&size, sizeof(unsigned));
+    std::vector<char> unpacked_bool_flags(size);
+    core_marker_input_stream.read((char *)unpacked_bool_flags.data(),
+                                  sizeof(char) * unpacked_bool_flags.size());
+    is_core_node.resize(size);
+    for (auto i = 0u; i < size; ++i)
+    {
+        is_core_node[i] = unpacked_bool_flags[i] != 0;
+    }
+}
+
 void Contractor::WriteNodeLevels(std::vector<float> &&in_node_levels) const
 {
     std::vector<float> node_levels(std::move(in_node_levels));
@@ -546,55 +617,89 @@ std::size_t
 Contractor::WriteContractedGraph(unsigned max_node_id,
                                  const util::DeallocatingVector<QueryEdge> &contracted_edge_list)
 {
+    using NodeArrayEntry = util::StaticGraph<EdgeData>::NodeArrayEntry;
+    using EdgeArrayEntry = util::StaticGraph<EdgeData>::EdgeArrayEntry;
+
     // Sorting contracted edges in a way that the static query graph can read some in in-place.
     tbb::parallel_sort(contracted_edge_list.begin(), contracted_edge_list.end());
     const unsigned contracted_edge_count = contracted_edge_list.size();
     util::SimpleLogger().Write() << "Serializing compacted graph of " << contracted_edge_count
                                  << " edges";
 
-    const util::FingerPrint fingerprint = util::FingerPrint::GetValid();
-    boost::filesystem::ofstream hsgr_output_stream(config.graph_output_path, std::ios::binary);
-    hsgr_output_stream.write((char *)&fingerprint, sizeof(util::FingerPrint));
-    const unsigned max_used_node_id = [&contracted_edge_list]
-    {
-        unsigned tmp_max = 0;
-        for (const QueryEdge &edge : contracted_edge_list)
+    const unsigned max_used_node_id = tbb::parallel_reduce(
+        tbb::blocked_range<std::size_t>(0, contracted_edge_count), 0u,
+        [&contracted_edge_list](const tbb::blocked_range<std::size_t> &range, unsigned tmp_max)
         {
-            BOOST_ASSERT(SPECIAL_NODEID != edge.source);
-            BOOST_ASSERT(SPECIAL_NODEID != edge.target);
-            tmp_max = std::max(tmp_max, edge.source);
-            tmp_max = std::max(tmp_max, edge.target);
-        }
-        return tmp_max;
-    }();
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                const QueryEdge &edge = contracted_edge_list[index];
+                BOOST_ASSERT(SPECIAL_NODEID != edge.source);
+                BOOST_ASSERT(SPECIAL_NODEID != edge.target);
+                tmp_max = std::max(tmp_max, edge.source);
+                tmp_max = std::max(tmp_max, edge.target);
+            }
+            return tmp_max;
+        },
+        [](const unsigned lhs, const unsigned rhs)
+        {
+            return std::max(lhs, rhs);
+        });
 
     util::SimpleLogger().Write(logDEBUG) << "input graph has " << (max_node_id + 1) << " nodes";
     util::SimpleLogger().Write(logDEBUG) << "contracted graph has " << (max_used_node_id + 1)
                                          << " nodes";
 
-    std::vector<util::StaticGraph<EdgeData>::NodeArrayEntry> node_array;
-    // make sure we have at least one sentinel
-    node_array.resize(max_node_id + 2);
-
-    util::SimpleLogger().Write() << "Building node array";
-    util::StaticGraph<EdgeData>::EdgeIterator edge = 0;
-    util::StaticGraph<EdgeData>::EdgeIterator position = 0;
-    util::StaticGraph<EdgeData>::EdgeIterator last_edge;
-
-    // initializing 'first_edge'-field of nodes:
-    for (const auto node : util::irange(0u, max_used_node_id + 1))
+#ifndef NDEBUG
+    for (const auto edge : util::irange<std::size_t>(0, contracted_edge_count))
     {
-        last_edge = edge;
-        while ((edge < contracted_edge_count) && (contracted_edge_list[edge].source == node))
+        // some self-loops are required for oneway handling. Need to assertthat we only keep these
+        // (TODO)
+        // every target needs to be valid
+        BOOST_ASSERT(contracted_edge_list[edge].target <= max_used_node_id);
+        if (contracted_edge_list[edge].data.distance <= 0)
         {
-            ++edge;
+            util::SimpleLogger().Write(logWARNING)
+                << "Edge: " << edge << ",source: " << contracted_edge_list[edge].source
+                << ", target: " << contracted_edge_list[edge].target
+                << ", dist: " << contracted_edge_list[edge].data.distance;
+
+            util::SimpleLogger().Write(logWARNING) << "Failed at adjacency list of node "
+                                                   << contracted_edge_list[edge].source << "/"
+                                                   << max_node_id + 1;
+            return 1;
         }
-        node_array[node].first_edge = position; //=edge
-        position += edge - last_edge;           // remove
     }
+#endif
+
+    // make sure we have at least one sentinel
+    std::vector<NodeArrayEntry> node_array(max_node_id + 2);
 
-    for (const auto sentinel_counter :
-         util::irange<unsigned>(max_used_node_id + 1, node_array.size()))
+    util::SimpleLogger().Write() << "Building node array";
+    // The edges are sorted by source, so every edge that starts a new source is the first edge
+    // of its source and of all nodes without edges in between. Each edge writes a disjoint
+    // range of nodes, which replaces the prefix sum over the degrees.
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, contracted_edge_count),
+        [&contracted_edge_list, &node_array](const tbb::blocked_range<std::size_t> &range)
+        {
+            for (auto edge = range.begin(); edge != range.end(); ++edge)
+            {
+                const NodeID source = contracted_edge_list[edge].source;
+                const NodeID first_node =
+                    edge == 0 ? 0 : contracted_edge_list[edge - 1].source + 1;
+                if (edge != 0 && first_node > source)
+                {
+                    continue;
+                }
+                for (NodeID node = first_node; node <= source; ++node)
+                {
+                    node_array[node].first_edge = edge;
+                }
+            }
+        });
+    const NodeID first_sentinel =
+        contracted_edge_count == 0 ? 0 : contracted_edge_list[contracted_edge_count - 1].source + 1;
+    for (const auto sentinel_counter : util::irange<unsigned>(first_sentinel, node_array.size()))
     {
         // sentinel element, guarded against underflow
         node_array[sentinel_counter].first_edge = contracted_edge_count;
@@ -602,10 +707,13 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
 
     util::SimpleLogger().Write() << "Serializing node array";
 
-    RangebasedCRC32 crc32_calculator;
-    const unsigned edges_crc32 = crc32_calculator(contracted_edge_list);
-    util::SimpleLogger().Write() << "Writing CRC32: " << edges_crc32;
+    const util::FingerPrint fingerprint = util::FingerPrint::GetValid();
+    boost::filesystem::ofstream hsgr_output_stream(config.graph_output_path, std::ios::binary);
+    hsgr_output_stream.write((char *)&fingerprint, sizeof(util::FingerPrint));
 
+    // the checksum is only known after all edges are written, it is patched in at the end
+    const auto crc32_position = hsgr_output_stream.tellp();
+    unsigned edges_crc32 = 0;
     const unsigned node_array_size = node_array.size();
     // serialize crc32, aka checksum
     hsgr_output_stream.write((char *)&edges_crc32, sizeof(unsigned));
@@ -617,48 +725,55 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
     if (node_array_size > 0)
     {
         hsgr_output_stream.write((char *)&node_array[0],
-                                 sizeof(util::StaticGraph<EdgeData>::NodeArrayEntry) *
-                                     node_array_size);
+                                 sizeof(NodeArrayEntry) * node_array_size);
     }
+    node_array.clear();
+    node_array.shrink_to_fit();
 
-    // serialize all edges
+    // serialize all edges in large blocks that are built in parallel and checksummed
+    // in the same pass
     util::SimpleLogger().Write() << "Building edge array";
-    int number_of_used_edges = 0;
-
-    util::StaticGraph<EdgeData>::EdgeArrayEntry current_edge;
-    for (const auto edge : util::irange<std::size_t>(0, contracted_edge_list.size()))
+    const constexpr std::size_t EDGE_BLOCK_SIZE = 4 * 1024 * 1024 / sizeof(EdgeArrayEntry);
+    std::vector<EdgeArrayEntry> edge_block(std::min<std::size_t>(EDGE_BLOCK_SIZE,
+                                                                 contracted_edge_count));
+    util::BlockCRC32 crc32_calculator;
+    for (std::size_t block_begin = 0; block_begin < contracted_edge_count;
+         block_begin += EDGE_BLOCK_SIZE)
     {
-        // some self-loops are required for oneway handling. Need to assertthat we only keep these
-        // (TODO)
-        // no eigen loops
-        // BOOST_ASSERT(contracted_edge_list[edge].source != contracted_edge_list[edge].target ||
-        // node_represents_oneway[contracted_edge_list[edge].source]);
-        current_edge.target = contracted_edge_list[edge].target;
-        current_edge.data = contracted_edge_list[edge].data;
+        const std::size_t block_end =
+            std::min<std::size_t>(block_begin + EDGE_BLOCK_SIZE, contracted_edge_count);
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(block_begin, block_end),
+            [&contracted_edge_list, &edge_block,
+             block_begin](const tbb::blocked_range<std::size_t> &range)
+            {
+                for (auto edge = range.begin(); edge != range.end(); ++edge)
+                {
+                    auto &current_edge = edge_block[edge - block_begin];
+                    current_edge.target = contracted_edge_list[edge].target;
+                    current_edge.data = contracted_edge_list[edge].data;
+                }
+            });
 
-        // every target needs to be valid
-        BOOST_ASSERT(current_edge.target <= max_used_node_id);
-#ifndef NDEBUG
-        if (current_edge.data.distance <= 0)
-        {
-            util::SimpleLogger().Write(logWARNING)
-                << "Edge: " << edge << ",source: " << contracted_edge_list[edge].source
-                << ", target: " << contracted_edge_list[edge].target
-                << ", dist: " << current_edge.data.distance;
+        const auto block_bytes = (block_end - block_begin) * sizeof(EdgeArrayEntry);
+        crc32_calculator.process(reinterpret_cast<const char *>(edge_block.data()),
+                                 block_bytes);
+        hsgr_output_stream.write(reinterpret_cast<const char *>(edge_block.data()),
+                                 block_bytes);
+    }
 
-            util::SimpleLogger().Write(logWARNING) << "Failed at adjacency list of node "
-                                                   << contracted_edge_list[edge].source << "/"
-                                                   << node_array.size() - 1;
-            return 1;
-        }
-#endif
-        hsgr_output_stream.write((char *)&current_edge,
-                                 sizeof(util::StaticGraph<EdgeData>::EdgeArrayEntry));
+    edges_crc32 = crc32_calculator.checksum();
+    util::SimpleLogger().Write() << "Writing CRC32: " << edges_crc32
+                                 << (crc32_calculator.using_hardware() ? " (hardware)" : "");
+    hsgr_output_stream.seekp(crc32_position);
+    hsgr_output_stream.write((char *)&edges_crc32, sizeof(unsigned));
 
-        ++number_of_used_edges;
+    if (!hsgr_output_stream)
+    {
+        throw util::exception("Failed writing " + config.graph_output_path);
     }
 
-    return number_of_used_edges;
+    return contracted_edge_count;
 }
 
 /**
@@ -677,10 +792,378 @@ void Contractor::ContractGraph(
 
     GraphContractor graph_contractor(max_edge_id + 1, edge_based_edge_list, std::move(node_levels),
                                      std::move(node_weights));
+    if (config.checkpoint_interval > 0)
+    {
+        graph_contractor.EnableCheckpoints(config.checkpoint_path, config.checkpoint_interval);
+    }
+    if (!config.round_statistics_path.empty())
+    {
+        graph_contractor.EnableRoundStatistics(config.round_statistics_path);
+    }
     graph_contractor.Run(config.core_factor);
     graph_contractor.GetEdges(contracted_edge_list);
     graph_contractor.GetCoreMarker(is_core_node);
     graph_contractor.GetNodeLevels(inout_node_levels);
 }
+/**
+ \brief Continue contracting the graph from the last checkpoint.
+ \param out_computed_node_levels false if the checkpoint followed given node levels, in which
+        case out_node_levels stays empty
+ \return the maximal node id of the edge-based graph
+ */
+unsigned Contractor::ResumeContractGraph(util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                                         std::vector<bool> &is_core_node,
+                                         std::vector<float> &out_node_levels,
+                                         bool &out_computed_node_levels) const
+{
+    if (!boost::filesystem::exists(config.checkpoint_path))
+    {
+        throw util::exception("No checkpoint found at " + config.checkpoint_path +
+                              ", run osrm-contract with --checkpoint-interval first");
+    }
+
+    util::SimpleLogger().Write() << "Loading checkpoint " << config.checkpoint_path;
+    GraphContractor graph_contractor(config.checkpoint_path);
+    const unsigned max_edge_id = graph_contractor.GetNumberOfInputNodes() - 1;
+    if (config.checkpoint_interval > 0)
+    {
+        graph_contractor.EnableCheckpoints(config.checkpoint_path, config.checkpoint_interval);
+    }
+    if (!config.round_statistics_path.empty())
+    {
+        graph_contractor.EnableRoundStatistics(config.round_statistics_path);
+    }
+    graph_contractor.Run(config.core_factor);
+    graph_contractor.GetEdges(contracted_edge_list);
+    graph_contractor.GetCoreMarker(is_core_node);
+    graph_contractor.GetNodeLevels(out_node_levels);
+    out_computed_node_levels = !graph_contractor.UsedCachedNodeLevels();
+
+    return max_edge_id;
+}
+/**
+ \brief Update the previous hierarchy after edge weight changes.
+
+ Nodes incident to edges whose weight differs from the previous .hsgr, their neighbourhood and
+ everything reachable upwards from them in the previous hierarchy form the core. Since the core
+ is closed upwards, the edges stored at all other nodes are still valid and are kept as-is. Only
+ the core is contracted again, from its original edges with the new weights and the shortcuts
+ that bypass non-core nodes. Core nodes are ordered above all other nodes.
+
+ Witness searches of the kept nodes are not repeated, so the radius should cover the
+ neighbourhood in which weight increases could invalidate a witness path.
+ */
+void Contractor::RecontractCore(
+    const unsigned max_edge_id,
+    util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+    std::vector<EdgeWeight> &&node_weights,
+    std::vector<bool> &is_core_node,
+    std::vector<float> &out_node_levels) const
+{
+    using QueryGraph = util::StaticGraph<EdgeData>;
+    const NodeID number_of_nodes = max_edge_id + 1;
+
+    std::vector<float> node_levels;
+    ReadNodeLevels(node_levels);
+    if (node_levels.size() != number_of_nodes)
+    {
+        throw util::exception("Updating the core requires the .level file of a previous "
+                              "contraction of the same graph");
+    }
+
+    std::vector<QueryGraph::NodeArrayEntry> node_array;
+    std::vector<QueryGraph::EdgeArrayEntry> edge_array;
+    unsigned check_sum = 0;
+    util::readHSGRFromStream(config.graph_output_path, node_array, edge_array, &check_sum);
+    if (node_array.size() < number_of_nodes + 1)
+    {
+        throw util::exception(config.graph_output_path + " does not match the edge-based graph");
+    }
+
+    // nodes that were not contracted in the previous run have no valid order
+    std::vector<bool> is_update_core;
+    ReadCoreNodeMarker(is_update_core);
+    is_update_core.resize(number_of_nodes, false);
+
+    // Find all edges whose weight differs from the weight used in the previous hierarchy. The
+    // contractor merges parallel edges and edges in both directions between two nodes, so the
+    // weights are compared by source and target instead of by edge id.
+    struct DirectedWeight
+    {
+        NodeID source;
+        NodeID target;
+        EdgeWeight weight;
+    };
+    const auto sort_and_keep_minimum = [](std::vector<DirectedWeight> &weights) {
+        tbb::parallel_sort(weights.begin(), weights.end(),
+                           [](const DirectedWeight &lhs, const DirectedWeight &rhs) {
+                               return std::tie(lhs.source, lhs.target, lhs.weight) <
+                                      std::tie(rhs.source, rhs.target, rhs.weight);
+                           });
+        weights.erase(std::unique(weights.begin(), weights.end(),
+                                  [](const DirectedWeight &lhs, const DirectedWeight &rhs) {
+                                      return lhs.source == rhs.source &&
+                                             lhs.target == rhs.target;
+                                  }),
+                      weights.end());
+    };
+
+    std::vector<DirectedWeight> previous_weights;
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        for (auto edge = node_array[node].first_edge; edge < node_array[node + 1].first_edge;
+             ++edge)
+        {
+            const auto &data = edge_array[edge].data;
+            if (data.shortcut)
+            {
+                continue;
+            }
+            if (data.forward)
+            {
+                previous_weights.push_back({node, edge_array[edge].target, data.distance});
+            }
+            if (data.backward)
+            {
+                previous_weights.push_back({edge_array[edge].target, node, data.distance});
+            }
+        }
+    }
+    sort_and_keep_minimum(previous_weights);
+
+    std::vector<DirectedWeight> current_weights;
+    for (const auto &edge : edge_based_edge_list)
+    {
+        // the edge list may hold unused default edges, and self-loops are dropped by the
+        // contractor
+        if (edge.source == edge.target)
+        {
+            continue;
+        }
+        const EdgeWeight weight = std::max(edge.weight, 1);
+        if (edge.forward)
+        {
+            current_weights.push_back({edge.source, edge.target, weight});
+        }
+        if (edge.backward)
+        {
+            current_weights.push_back({edge.target, edge.source, weight});
+        }
+    }
+    sort_and_keep_minimum(current_weights);
+
+    std::size_t number_of_changed_edges = 0;
+    const auto mark_changed = [&](const DirectedWeight &changed) {
+        is_update_core[changed.source] = true;
+        is_update_core[changed.target] = true;
+        ++number_of_changed_edges;
+    };
+    auto previous = previous_weights.begin();
+    for (const auto &current : current_weights)
+    {
+        while (previous != previous_weights.end() &&
+               std::tie(previous->source, previous->target) <
+                   std::tie(current.source, current.target))
+        {
+            // an edge the previous hierarchy used is gone
+            mark_changed(*previous++);
+        }
+        if (previous != previous_weights.end() && previous->source == current.source &&
+            previous->target == current.target)
+        {
+            if (previous->weight != current.weight)
+            {
+                mark_changed(current);
+            }
+            ++previous;
+        }
+        else
+        {
+            // new edge, or an edge that a shortcut replaced in the previous hierarchy
+            mark_changed(current);
+        }
+    }
+    while (previous != previous_weights.end())
+    {
+        mark_changed(*previous++);
+    }
+    previous_weights.clear();
+    previous_weights.shrink_to_fit();
+    current_weights.clear();
+    current_weights.shrink_to_fit();
+
+    // grow the changed region by the requested number of hops
+    for (unsigned hop = 0; hop < config.core_update_radius; ++hop)
+    {
+        std::vector<bool> grown_core = is_update_core;
+        for (const auto &edge : edge_based_edge_list)
+        {
+            if (is_update_core[edge.source] || is_update_core[edge.target])
+            {
+                grown_core[edge.source] = true;
+                grown_core[edge.target] = true;
+            }
+        }
+        is_update_core.swap(grown_core);
+    }
+
+    // close the core upwards: edges are stored at their lower node
+    std::vector<NodeID> stack;
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        if (is_update_core[node])
+        {
+            stack.push_back(node);
+        }
+    }
+    while (!stack.empty())
+    {
+        const NodeID node = stack.back();
+        stack.pop_back();
+        for (auto edge = node_array[node].first_edge; edge < node_array[node + 1].first_edge;
+             ++edge)
+        {
+            const NodeID target = edge_array[edge].target;
+            if (!is_update_core[target])
+            {
+                is_update_core[target] = true;
+                stack.push_back(target);
+            }
+        }
+    }
+
+    std::vector<NodeID> core_nodes;
+    std::vector<NodeID> core_id_of_node(number_of_nodes, SPECIAL_NODEID);
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        if (is_update_core[node])
+        {
+            core_id_of_node[node] = core_nodes.size();
+            core_nodes.push_back(node);
+        }
+    }
+    util::SimpleLogger().Write() << number_of_changed_edges << " changed edges, recontracting "
+                                 << core_nodes.size() << " of " << number_of_nodes << " nodes";
+
+    // keep the hierarchy below the core
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        if (is_update_core[node])
+        {
+            continue;
+        }
+        for (auto edge = node_array[node].first_edge; edge < node_array[node + 1].first_edge;
+             ++edge)
+        {
+            contracted_edge_list.push_back(
+                QueryEdge{node, edge_array[edge].target, edge_array[edge].data});
+        }
+    }
+
+    // The core is contracted with dense ids. Its input edges carry an index into
+    // core_edge_origin as id, to restore whether they are original edges or shortcuts.
+    struct CoreEdgeOrigin
+    {
+        bool shortcut;
+        NodeID id;
+    };
+    std::vector<CoreEdgeOrigin> core_edge_origin;
+    util::DeallocatingVector<extractor::EdgeBasedEdge> core_edge_list;
+    for (const auto &edge : edge_based_edge_list)
+    {
+        if (is_update_core[edge.source] && is_update_core[edge.target])
+        {
+            core_edge_list.push_back(extractor::EdgeBasedEdge(
+                core_id_of_node[edge.source], core_id_of_node[edge.target],
+                core_edge_origin.size(), edge.weight, edge.forward, edge.backward));
+            core_edge_origin.push_back(CoreEdgeOrigin{false, edge.edge_id});
+        }
+    }
+    edge_based_edge_list.clear();
+    for (const auto node : core_nodes)
+    {
+        for (auto edge = node_array[node].first_edge; edge < node_array[node + 1].first_edge;
+             ++edge)
+        {
+            const auto &data = edge_array[edge].data;
+            // original edges were added with their new weight, shortcuts over core nodes are
+            // recomputed by the contraction below
+            if (!data.shortcut || is_update_core[data.id])
+            {
+                continue;
+            }
+            BOOST_ASSERT(is_update_core[edge_array[edge].target]);
+            core_edge_list.push_back(extractor::EdgeBasedEdge(
+                core_id_of_node[node], core_id_of_node[edge_array[edge].target],
+                core_edge_origin.size(), data.distance, data.forward, data.backward));
+            core_edge_origin.push_back(CoreEdgeOrigin{true, data.id});
+        }
+    }
+    node_array.clear();
+    node_array.shrink_to_fit();
+    edge_array.clear();
+    edge_array.shrink_to_fit();
+
+    std::vector<EdgeWeight> core_node_weights(core_nodes.size());
+    for (const auto core_id : util::irange<std::size_t>(0, core_nodes.size()))
+    {
+        core_node_weights[core_id] = node_weights[core_nodes[core_id]];
+    }
+    node_weights.clear();
+    node_weights.shrink_to_fit();
+
+    util::DeallocatingVector<QueryEdge> core_contracted_edge_list;
+    std::vector<bool> core_is_core_node;
+    std::vector<float> core_node_levels;
+    {
+        GraphContractor graph_contractor(core_nodes.size(), core_edge_list, {},
+                                         std::move(core_node_weights));
+        if (!config.round_statistics_path.empty())
+        {
+            graph_contractor.EnableRoundStatistics(config.round_statistics_path);
+        }
+        graph_contractor.Run(config.core_factor);
+        graph_contractor.GetEdges(core_contracted_edge_list);
+        graph_contractor.GetCoreMarker(core_is_core_node);
+        graph_contractor.GetNodeLevels(core_node_levels);
+    }
+
+    for (auto edge : core_contracted_edge_list)
+    {
+        edge.source = core_nodes[edge.source];
+        edge.target = core_nodes[edge.target];
+        if (edge.data.shortcut)
+        {
+            edge.data.id = core_nodes[edge.data.id];
+        }
+        else
+        {
+            const auto &origin = core_edge_origin[edge.data.id];
+            edge.data.shortcut = origin.shortcut;
+            edge.data.id = origin.id;
+        }
+        contracted_edge_list.push_back(edge);
+    }
+
+    // core nodes are ordered above all kept nodes
+    const float max_level = *std::max_element(node_levels.begin(), node_levels.end());
+    for (const auto core_id : util::irange<std::size_t>(0, core_nodes.size()))
+    {
+        node_levels[core_nodes[core_id]] =
+            max_level + 1 + (core_node_levels.empty() ? 0 : core_node_levels[core_id]);
+    }
+    out_node_levels.swap(node_levels);
+
+    is_core_node.clear();
+    if (!core_is_core_node.empty())
+    {
+        is_core_node.resize(number_of_nodes, false);
+        for (const auto core_id : util::irange<std::size_t>(0, core_nodes.size()))
+        {
+            is_core_node[core_nodes[core_id]] = core_is_core_node[core_id];
+        }
+    }
+}
 }
 }
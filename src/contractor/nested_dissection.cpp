@@ -0,0 +1,272 @@
+#include "contractor/nested_dissection.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+// cells up to this size are not split further
+const constexpr std::size_t LEAF_CELL_SIZE = 64;
+// cells smaller than this are dissected by the calling thread only
+const constexpr std::size_t PARALLEL_CELL_SIZE = 10000;
+const constexpr std::uint32_t INVALID_LEVEL = std::numeric_limits<std::uint32_t>::max();
+}
+
+NestedDissection::NestedDissection(
+    const NodeID number_of_nodes, const util::DeallocatingVector<extractor::EdgeBasedEdge> &edges)
+    : cell_of_node(number_of_nodes, 0), bfs_level(number_of_nodes, INVALID_LEVEL),
+      separator_depth(number_of_nodes, INVALID_LEVEL), next_cell_id(1)
+{
+    std::vector<std::pair<NodeID, NodeID>> undirected_edges;
+    undirected_edges.reserve(edges.size() * 2);
+    for (const auto &edge : edges)
+    {
+        if (edge.source == edge.target)
+        {
+            continue;
+        }
+        BOOST_ASSERT(edge.source < number_of_nodes);
+        BOOST_ASSERT(edge.target < number_of_nodes);
+        undirected_edges.emplace_back(edge.source, edge.target);
+        undirected_edges.emplace_back(edge.target, edge.source);
+    }
+    tbb::parallel_sort(undirected_edges.begin(), undirected_edges.end());
+    undirected_edges.erase(std::unique(undirected_edges.begin(), undirected_edges.end()),
+                           undirected_edges.end());
+
+    first_edge.resize(number_of_nodes + 1, 0);
+    targets.resize(undirected_edges.size());
+    for (const auto index : util::irange<std::size_t>(0, undirected_edges.size()))
+    {
+        ++first_edge[undirected_edges[index].first + 1];
+        targets[index] = undirected_edges[index].second;
+    }
+    for (const auto node : util::irange<std::size_t>(0, number_of_nodes))
+    {
+        first_edge[node + 1] += first_edge[node];
+    }
+}
+
+std::vector<float> NestedDissection::ComputeNodeLevels()
+{
+    const NodeID number_of_nodes = cell_of_node.size();
+
+    std::vector<NodeID> all_nodes(number_of_nodes);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        all_nodes[node] = node;
+    }
+    // all nodes start out in cell 0
+    Dissect(std::move(all_nodes), 0, 0);
+
+    std::uint32_t max_depth = 0;
+    for (const auto depth : separator_depth)
+    {
+        if (depth != INVALID_LEVEL)
+        {
+            max_depth = std::max(max_depth, depth);
+        }
+    }
+
+    std::uint64_t max_degree = 0;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        max_degree = std::max(max_degree, first_edge[node + 1] - first_edge[node]);
+    }
+
+    std::vector<float> node_levels(number_of_nodes, 0.f);
+    std::size_t number_of_separator_nodes = 0;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (separator_depth[node] != INVALID_LEVEL)
+        {
+            node_levels[node] = static_cast<float>(max_depth - separator_depth[node] + 1);
+            ++number_of_separator_nodes;
+        }
+        // Within a level nodes of low degree go first, they add the fewest shortcuts. The
+        // fraction stays below 1, so it never reorders levels.
+        const auto degree = first_edge[node + 1] - first_edge[node];
+        node_levels[node] += static_cast<float>(degree) / static_cast<float>(max_degree + 1);
+    }
+
+    util::SimpleLogger().Write() << "nested dissection: " << next_cell_id << " cells, "
+                                 << number_of_separator_nodes << " separator nodes, depth "
+                                 << (max_depth + 1);
+
+    return node_levels;
+}
+
+std::uint32_t NestedDissection::NextCellID() { return next_cell_id++; }
+
+// Runs a BFS restricted to the nodes of cell_id, recording the BFS level of every reached node.
+// The reached nodes are appended to order in BFS order. Returns the last node reached.
+NodeID NestedDissection::BreadthFirstSearch(const NodeID start,
+                                            const std::uint32_t cell_id,
+                                            std::vector<NodeID> &order)
+{
+    order.clear();
+    order.push_back(start);
+    bfs_level[start] = 0;
+    for (std::size_t index = 0; index < order.size(); ++index)
+    {
+        const NodeID node = order[index];
+        for (auto edge = first_edge[node]; edge < first_edge[node + 1]; ++edge)
+        {
+            const NodeID target = targets[edge];
+            if (cell_of_node[target] == cell_id && bfs_level[target] == INVALID_LEVEL)
+            {
+                bfs_level[target] = bfs_level[node] + 1;
+                order.push_back(target);
+            }
+        }
+    }
+    return order.back();
+}
+
+void NestedDissection::Dissect(std::vector<NodeID> cell,
+                               const std::uint32_t cell_id,
+                               const std::uint32_t depth)
+{
+    if (cell.size() <= LEAF_CELL_SIZE)
+    {
+        return;
+    }
+
+    const auto reset_levels = [this](const std::vector<NodeID> &nodes)
+    {
+        for (const auto node : nodes)
+        {
+            bfs_level[node] = INVALID_LEVEL;
+        }
+    };
+
+    const auto recurse = [this](std::vector<NodeID> &&sub_cell, const std::uint32_t sub_depth)
+    {
+        const auto sub_cell_id = NextCellID();
+        for (const auto node : sub_cell)
+        {
+            cell_of_node[node] = sub_cell_id;
+        }
+        Dissect(std::move(sub_cell), sub_cell_id, sub_depth);
+    };
+
+    std::vector<NodeID> order;
+    order.reserve(cell.size());
+    const NodeID peripheral_node = BreadthFirstSearch(cell.front(), cell_id, order);
+
+    // the cell is disconnected: its components are dissected independently, no separator needed
+    if (order.size() < cell.size())
+    {
+        std::vector<std::vector<NodeID>> components;
+        components.push_back(order);
+        for (const auto node : cell)
+        {
+            if (bfs_level[node] == INVALID_LEVEL)
+            {
+                BreadthFirstSearch(node, cell_id, order);
+                components.push_back(order);
+            }
+        }
+        reset_levels(cell);
+        cell.clear();
+        cell.shrink_to_fit();
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, components.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range)
+                          {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  recurse(std::move(components[index]), depth);
+                              }
+                          });
+        return;
+    }
+
+    // second sweep from a pseudo-peripheral node, which yields a deep level structure
+    reset_levels(order);
+    BreadthFirstSearch(peripheral_node, cell_id, order);
+
+    // nodes are in BFS order, so the median level is the level of the median node
+    const std::uint32_t separator_level = bfs_level[order[order.size() / 2]];
+
+    std::vector<NodeID> lower_cell;
+    std::vector<NodeID> upper_cell;
+    std::vector<NodeID> separator;
+    for (const auto node : order)
+    {
+        const auto level = bfs_level[node];
+        if (level < separator_level)
+        {
+            lower_cell.push_back(node);
+        }
+        else if (level > separator_level)
+        {
+            upper_cell.push_back(node);
+        }
+        else
+        {
+            // a separator node is only needed if it is adjacent to the upper part
+            bool is_needed = false;
+            for (auto edge = first_edge[node]; edge < first_edge[node + 1] && !is_needed; ++edge)
+            {
+                const NodeID target = targets[edge];
+                is_needed = cell_of_node[target] == cell_id && bfs_level[target] > level &&
+                            bfs_level[target] != INVALID_LEVEL;
+            }
+            if (is_needed)
+            {
+                separator.push_back(node);
+            }
+            else
+            {
+                lower_cell.push_back(node);
+            }
+        }
+    }
+    reset_levels(order);
+    order.clear();
+    order.shrink_to_fit();
+    cell.clear();
+    cell.shrink_to_fit();
+
+    // a shallow level structure does not split the cell, leave it to the contractor
+    if (lower_cell.empty() || upper_cell.empty())
+    {
+        return;
+    }
+
+    for (const auto node : separator)
+    {
+        separator_depth[node] = depth;
+        // separator nodes leave the cell, so the sub-cells are no longer connected
+        cell_of_node[node] = std::numeric_limits<std::uint32_t>::max();
+    }
+
+    if (lower_cell.size() + upper_cell.size() > PARALLEL_CELL_SIZE)
+    {
+        tbb::parallel_invoke([&] { recurse(std::move(lower_cell), depth + 1); },
+                             [&] { recurse(std::move(upper_cell), depth + 1); });
+    }
+    else
+    {
+        recurse(std::move(lower_cell), depth + 1);
+        recurse(std::move(upper_cell), depth + 1);
+    }
+}
+}
+}
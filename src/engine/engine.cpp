@@ -13,142 +13,252 @@
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/datafacade/internal_datafacade.hpp"
 #include "engine/datafacade/shared_datafacade.hpp"
+#include "engine/dataset_epochs.hpp"
 
-#include "storage/shared_barriers.hpp"
 #include "util/make_unique.hpp"
+#include "util/integer_range.hpp"
+#include "util/numa.hpp"
 #include "util/simple_logger.hpp"
 
 #include <boost/assert.hpp>
-#include <boost/interprocess/sync/named_condition.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
-#include <boost/thread/lock_types.hpp>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
+namespace
+{
+// how often to look for datasets osrm-datastore loaded into shared memory
+const constexpr std::chrono::milliseconds UPDATE_POLL_INTERVAL(100);
+
+template <typename Plugin, typename Facade, typename... Args>
+std::unique_ptr<Plugin> create(Facade &facade, Args... args)
+{
+    return osrm::util::make_unique<Plugin>(facade, std::forward<Args>(args)...);
+}
+
+} // anon. ns
+
 namespace osrm
 {
 namespace engine
 {
-struct Engine::EngineLock
-{
-    // will only be initialized if shared memory is used
-    storage::SharedBarriers barrier;
-    // decrease number of concurrent queries
-    void DecreaseQueryCount();
-    // increase number of concurrent queries
-    void IncreaseQueryCount();
-};
 
-// decrease number of concurrent queries
-void Engine::EngineLock::DecreaseQueryCount()
+struct Engine::DatasetReplica
 {
-    // lock query
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
-
-    // decrement query count
-    --(barrier.number_of_queries);
-    BOOST_ASSERT_MSG(0 <= barrier.number_of_queries, "invalid number of queries");
-
-    // notify all processes that were waiting for this condition
-    if (0 == barrier.number_of_queries)
+    explicit DatasetReplica(EngineConfig &config)
     {
-        barrier.no_running_queries_condition.notify_all();
-    }
-}
+        if (config.use_shared_memory)
+        {
+            query_data_facade =
+                util::make_unique<datafacade::SharedDataFacade>(config.dataset_name);
+        }
+        else if (!config.storage_config.dataset_path.empty())
+        {
+            query_data_facade = util::make_unique<datafacade::SharedDataFacade>(
+                config.storage_config.dataset_path);
+        }
+        else
+        {
+            query_data_facade =
+                util::make_unique<datafacade::InternalDataFacade>(config.storage_config);
+        }
 
-// increase number of concurrent queries
-void Engine::EngineLock::IncreaseQueryCount()
-{
-    // lock update pending
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> pending_lock(
-        barrier.pending_update_mutex);
+        // Register plugins
+        using namespace plugins;
 
-    // lock query
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
+        route_plugin = create<ViaRoutePlugin>(*query_data_facade, config.max_locations_viaroute);
+        table_plugin = create<TablePlugin>(*query_data_facade, config.max_locations_distance_table);
+        nearest_plugin = create<NearestPlugin>(*query_data_facade);
+        trip_plugin = create<TripPlugin>(*query_data_facade, config.max_locations_trip);
+        match_plugin = create<MatchPlugin>(*query_data_facade, config.max_locations_map_matching);
+        tile_plugin = create<TilePlugin>(*query_data_facade);
+    }
 
-    // unlock update pending
-    pending_lock.unlock();
+    std::unique_ptr<datafacade::BaseDataFacade> query_data_facade;
 
-    // increment query count
-    ++(barrier.number_of_queries);
-}
-} // ns engine
-} // ns osrm
+    std::unique_ptr<plugins::ViaRoutePlugin> route_plugin;
+    std::unique_ptr<plugins::TablePlugin> table_plugin;
+    std::unique_ptr<plugins::NearestPlugin> nearest_plugin;
+    std::unique_ptr<plugins::TripPlugin> trip_plugin;
+    std::unique_ptr<plugins::MatchPlugin> match_plugin;
+    std::unique_ptr<plugins::TilePlugin> tile_plugin;
+};
 
-namespace
-{
-// Abstracted away the query locking into a template function
-// Works the same for every plugin.
-template <typename ParameterT, typename PluginT, typename ResultT>
-osrm::engine::Status RunQuery(const std::unique_ptr<osrm::engine::Engine::EngineLock> &lock,
-                              osrm::engine::datafacade::BaseDataFacade &facade,
-                              const ParameterT &parameters,
-                              PluginT &plugin,
-                              ResultT &result)
+// Loads new shared memory datasets into a standby replica on a thread of its own. The
+// replica is prefaulted there and swapped in when it is ready, so queries never wait for a
+// reload and don't pay for the page faults of a fresh mapping. Queries still running on the
+// previous replica keep it pinned until they are done, then its memory is released.
+class Engine::DatasetUpdater
 {
-    if (!lock)
+  public:
+    explicit DatasetUpdater(const EngineConfig &config_)
+        : config(config_), update_failed(false), stopped(false)
     {
-        return plugin.HandleRequest(parameters, result);
+        standby_replicas[0] = util::make_unique<DatasetReplica>(config);
+        current.store(standby_replicas[0].get());
+        thread = std::thread([this] {
+            Run();
+        });
     }
 
-    BOOST_ASSERT(lock);
-    lock->IncreaseQueryCount();
+    ~DatasetUpdater()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex);
+            stopped = true;
+        }
+        stop_condition.notify_one();
+        thread.join();
+    }
 
-    auto &shared_facade = static_cast<osrm::engine::datafacade::SharedDataFacade &>(facade);
-    shared_facade.CheckAndReloadFacade();
-    // Get a shared data lock so that other threads won't update
-    // things while the query is running
-    boost::shared_lock<boost::shared_mutex> data_lock{shared_facade.data_mutex};
+    // queries pin the current replica, so that it isn't released while they run
+    DatasetEpochs epochs;
+    std::atomic<DatasetReplica *> current;
 
-    osrm::engine::Status status = plugin.HandleRequest(parameters, result);
+  private:
+    static datafacade::SharedDataFacade &GetFacade(DatasetReplica &replica)
+    {
+        return static_cast<datafacade::SharedDataFacade &>(*replica.query_data_facade);
+    }
 
-    lock->DecreaseQueryCount();
-    return status;
-}
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(stop_mutex);
+        while (!stop_condition.wait_for(lock, UPDATE_POLL_INTERVAL, [this] {
+            return stopped;
+        }))
+        {
+            if (GetFacade(*current.load()).IsOutdated())
+            {
+                lock.unlock();
+                Update();
+                lock.lock();
+            }
+        }
+    }
 
-template <typename Plugin, typename Facade, typename... Args>
-std::unique_ptr<Plugin> create(Facade &facade, Args... args)
-{
-    return osrm::util::make_unique<Plugin>(facade, std::forward<Args>(args)...);
-}
+    void Update()
+    {
+        auto *previous = current.load();
+        auto &next =
+            standby_replicas[0].get() == previous ? standby_replicas[1] : standby_replicas[0];
+        try
+        {
+            if (next)
+            {
+                GetFacade(*next).Reload();
+            }
+            else
+            {
+                next = util::make_unique<DatasetReplica>(config);
+            }
+            GetFacade(*next).Prefault();
+        }
+        catch (const std::exception &e)
+        {
+            // e.g. osrm-datastore replaced the dataset again while we loaded it, retry later
+            if (!update_failed)
+            {
+                util::SimpleLogger().Write(logWARNING) << "could not load the new dataset: "
+                                                       << e.what();
+            }
+            update_failed = true;
+            return;
+        }
+        update_failed = false;
 
-} // anon. ns
+        current.store(next.get());
+        epochs.Synchronize();
+        // no query uses the previous replica anymore
+        GetFacade(*previous).Release();
+        util::SimpleLogger().Write() << "swapped in the new dataset";
+    }
 
-namespace osrm
-{
-namespace engine
-{
+    EngineConfig config;
+    // the current replica and the one updates are loaded into
+    std::array<std::unique_ptr<DatasetReplica>, 2> standby_replicas;
+    bool update_failed;
+
+    std::mutex stop_mutex;
+    std::condition_variable stop_condition;
+    bool stopped;
+    std::thread thread;
+};
 
 Engine::Engine(EngineConfig &config)
 {
+    if (!config.use_shared_memory && !config.storage_config.IsValid())
+    {
+        throw util::exception("Invalid file paths given!");
+    }
+
+    const util::NumaTopology topology;
+    const bool replicate = config.use_numa_replicas && topology.NumberOfNodes() > 1;
+    const bool is_mapped = !config.storage_config.dataset_path.empty();
+    if (replicate && (config.use_shared_memory || is_mapped))
+    {
+        // all processes share the one copy osrm-datastore loaded or the page cache holds
+        util::SimpleLogger().Write(logWARNING)
+            << "shared and mapped datasets are not replicated across NUMA nodes";
+    }
+
     if (config.use_shared_memory)
     {
-        lock = util::make_unique<EngineLock>();
-        query_data_facade = util::make_unique<datafacade::SharedDataFacade>();
+        updater = util::make_unique<DatasetUpdater>(config);
+        return;
+    }
+
+    if (!replicate || is_mapped)
+    {
+        replicas.push_back(util::make_unique<DatasetReplica>(config));
+        return;
     }
-    else
+
+    // Load every replica on a thread bound to its node, so the kernel places its pages there
+    util::SimpleLogger().Write() << "loading one copy of the dataset per NUMA node ("
+                                 << topology.NumberOfNodes() << " nodes)";
+    replicas.resize(topology.NumberOfNodes());
+    std::vector<std::exception_ptr> errors(replicas.size());
+    std::vector<std::thread> loaders;
+    for (const auto node : util::irange(0u, topology.NumberOfNodes()))
     {
-        if (!config.storage_config.IsValid())
+        loaders.emplace_back([&, node] {
+            try
+            {
+                if (!topology.BindCurrentThread(node))
+                {
+                    util::SimpleLogger().Write(logWARNING) << "could not bind to NUMA node "
+                                                           << node;
+                }
+                replicas[node] = util::make_unique<DatasetReplica>(config);
+            }
+            catch (...)
+            {
+                errors[node] = std::current_exception();
+            }
+        });
+    }
+    for (auto &loader : loaders)
+    {
+        loader.join();
+    }
+    for (const auto &error : errors)
+    {
+        if (error)
         {
-            throw util::exception("Invalid file paths given!");
+            std::rethrow_exception(error);
         }
-        query_data_facade = util::make_unique<datafacade::InternalDataFacade>(config.storage_config);
     }
-
-    // Register plugins
-    using namespace plugins;
-
-    route_plugin = create<ViaRoutePlugin>(*query_data_facade, config.max_locations_viaroute);
-    table_plugin = create<TablePlugin>(*query_data_facade, config.max_locations_distance_table);
-    nearest_plugin = create<NearestPlugin>(*query_data_facade);
-    trip_plugin = create<TripPlugin>(*query_data_facade, config.max_locations_trip);
-    match_plugin = create<MatchPlugin>(*query_data_facade, config.max_locations_map_matching);
-    tile_plugin = create<TilePlugin>(*query_data_facade);
+    cpu_to_replica = topology.CPUToNode();
 }
 
 // make sure we deallocate the unique ptr at a position where we know the size of the plugins
@@ -156,34 +266,68 @@ Engine::~Engine() = default;
 Engine::Engine(Engine &&) noexcept = default;
 Engine &Engine::operator=(Engine &&) noexcept = default;
 
+const Engine::DatasetReplica &Engine::LocalReplica() const
+{
+    // Threads that aren't bound might migrate during the query, which costs speed only
+    const int cpu = util::NumaTopology::CurrentCPU();
+    if (cpu >= 0 && static_cast<unsigned>(cpu) < cpu_to_replica.size())
+    {
+        return *replicas[cpu_to_replica[cpu]];
+    }
+    return *replicas.front();
+}
+
+template <typename QueryT> Status Engine::RunQuery(const QueryT &query) const
+{
+    if (!updater)
+    {
+        return query(LocalReplica());
+    }
+    // Pin the current replica, so that the updater won't release it while the query runs
+    const DatasetEpochs::ReadGuard pin(updater->epochs);
+    return query(*updater->current.load());
+}
+
 Status Engine::Route(const api::RouteParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *route_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.route_plugin->HandleRequest(params, result);
+    });
 }
 
 Status Engine::Table(const api::TableParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *table_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.table_plugin->HandleRequest(params, result);
+    });
 }
 
 Status Engine::Nearest(const api::NearestParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *nearest_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.nearest_plugin->HandleRequest(params, result);
+    });
 }
 
 Status Engine::Trip(const api::TripParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *trip_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.trip_plugin->HandleRequest(params, result);
+    });
 }
 
 Status Engine::Match(const api::MatchParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *match_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.match_plugin->HandleRequest(params, result);
+    });
 }
 
 Status Engine::Tile(const api::TileParameters &params, std::string &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *tile_plugin, result);
+    return RunQuery([&](const DatasetReplica &replica) {
+        return replica.tile_plugin->HandleRequest(params, result);
+    });
 }
 
 } // engine ns
@@ -1,4 +1,5 @@
 #include "engine/engine_config.hpp"
+#include "storage/shared_memory.hpp"
 
 namespace osrm
 {
@@ -21,7 +22,8 @@ bool EngineConfig::IsValid() const
         (max_locations_trip == -1 || max_locations_trip > 2) &&
         (max_locations_viaroute == -1 || max_locations_viaroute > 2);
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) &&
+           limits_valid && storage::IsValidDatasetName(dataset_name);
 }
 }
 }
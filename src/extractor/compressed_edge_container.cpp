@@ -5,6 +5,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -15,6 +16,8 @@ namespace osrm
 namespace extractor
 {
 
+constexpr const unsigned CompressedEdgeContainer::INVALID_BUCKET_INDEX;
+
 CompressedEdgeContainer::CompressedEdgeContainer()
 {
     m_free_list.reserve(100);
@@ -33,16 +36,27 @@ void CompressedEdgeContainer::IncreaseFreeList()
 
 bool CompressedEdgeContainer::HasEntryForID(const EdgeID edge_id) const
 {
-    auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    return iter != m_edge_id_to_list_index_map.end();
+    return edge_id < m_edge_id_to_list_index.size() &&
+           m_edge_id_to_list_index[edge_id] != INVALID_BUCKET_INDEX;
 }
 
 unsigned CompressedEdgeContainer::GetPositionForID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_edge_id_to_list_index_map.end());
-    BOOST_ASSERT(map_iterator->second < m_compressed_geometries.size());
-    return map_iterator->second;
+    BOOST_ASSERT(HasEntryForID(edge_id));
+    BOOST_ASSERT(m_edge_id_to_list_index[edge_id] < m_compressed_geometries.size());
+    return m_edge_id_to_list_index[edge_id];
+}
+
+void CompressedEdgeContainer::SetPositionForID(const EdgeID edge_id, const unsigned index)
+{
+    if (edge_id >= m_edge_id_to_list_index.size())
+    {
+        // edge ids are dense, grow geometrically to keep appends amortized constant
+        m_edge_id_to_list_index.resize(
+            std::max<std::size_t>(edge_id + 1, 2 * m_edge_id_to_list_index.size()),
+            INVALID_BUCKET_INDEX);
+    }
+    m_edge_id_to_list_index[edge_id] = index;
 }
 
 void CompressedEdgeContainer::SerializeInternalVector(const std::string &path) const
@@ -78,10 +92,8 @@ void CompressedEdgeContainer::SerializeInternalVector(const std::string &path) c
         const unsigned unpacked_size = current_vector.size();
         control_sum += unpacked_size;
         BOOST_ASSERT(std::numeric_limits<unsigned>::max() != unpacked_size);
-        for (const auto &current_node : current_vector)
-        {
-            geometry_out_stream.write((char *)&(current_node), sizeof(CompressedEdge));
-        }
+        geometry_out_stream.write((char *)current_vector.data(),
+                                  unpacked_size * sizeof(CompressedEdge));
     }
     BOOST_ASSERT(control_sum == prefix_sum_of_list_indices);
 }
@@ -126,16 +138,12 @@ void CompressedEdgeContainer::CompressEdge(const EdgeID edge_id_1,
             IncreaseFreeList();
         }
         BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id_1] = m_free_list.back();
+        SetPositionForID(edge_id_1, m_free_list.back());
         m_free_list.pop_back();
     }
 
     // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id_1);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id1 = iter->second;
-    BOOST_ASSERT(edge_bucket_id1 == GetPositionForID(edge_id_1));
-    BOOST_ASSERT(edge_bucket_id1 < m_compressed_geometries.size());
+    const unsigned edge_bucket_id1 = GetPositionForID(edge_id_1);
 
     std::vector<CompressedEdge> &edge_bucket_list1 = m_compressed_geometries[edge_bucket_id1];
 
@@ -163,9 +171,8 @@ void CompressedEdgeContainer::CompressEdge(const EdgeID edge_id_1,
                                  edge_bucket_list2.end());
 
         // remove the list of edge_id_2
-        m_edge_id_to_list_index_map.erase(edge_id_2);
-        BOOST_ASSERT(m_edge_id_to_list_index_map.end() ==
-                     m_edge_id_to_list_index_map.find(edge_id_2));
+        SetPositionForID(edge_id_2, INVALID_BUCKET_INDEX);
+        BOOST_ASSERT(!HasEntryForID(edge_id_2));
         edge_bucket_list2.clear();
         BOOST_ASSERT(0 == edge_bucket_list2.size());
         m_free_list.emplace_back(list_to_remove_index);
@@ -197,16 +204,12 @@ void CompressedEdgeContainer::AddUncompressedEdge(const EdgeID edge_id,
             IncreaseFreeList();
         }
         BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id] = m_free_list.back();
+        SetPositionForID(edge_id, m_free_list.back());
         m_free_list.pop_back();
     }
 
     // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id = iter->second;
-    BOOST_ASSERT(edge_bucket_id == GetPositionForID(edge_id));
-    BOOST_ASSERT(edge_bucket_id < m_compressed_geometries.size());
+    const unsigned edge_bucket_id = GetPositionForID(edge_id);
 
     std::vector<CompressedEdge> &edge_bucket_list = m_compressed_geometries[edge_bucket_id];
 
@@ -246,8 +249,7 @@ void CompressedEdgeContainer::PrintStatistics() const
 const CompressedEdgeContainer::EdgeBucket &
 CompressedEdgeContainer::GetBucketReference(const EdgeID edge_id) const
 {
-    const unsigned index = m_edge_id_to_list_index_map.at(edge_id);
-    return m_compressed_geometries.at(index);
+    return m_compressed_geometries.at(GetPositionForID(edge_id));
 }
 
 NodeID CompressedEdgeContainer::GetFirstEdgeTargetID(const EdgeID edge_id) const
@@ -1,10 +1,13 @@
 #include "extractor/edge_based_edge.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
+#include "extractor/scripting_environment.hpp"
+#include "extractor/turn_penalty_table.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/percent.hpp"
 #include "util/integer_range.hpp"
 #include "util/lua_util.hpp"
+#include "util/make_unique.hpp"
 #include "util/simple_logger.hpp"
 #include "util/timing_util.hpp"
 #include "util/exception.hpp"
@@ -14,11 +17,15 @@
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/pipeline.h>
+#include <tbb/task_scheduler_init.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -26,6 +33,15 @@ namespace osrm
 {
 namespace extractor
 {
+namespace
+{
+template <typename T> void appendBytes(std::vector<char> &buffer, const T &value)
+{
+    const auto bytes = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+}
+
 // Configuration to find representative candidate for turn angle calculations
 
 EdgeBasedGraphFactory::EdgeBasedGraphFactory(
@@ -172,7 +188,7 @@ void EdgeBasedGraphFactory::FlushVectorToStream(
 }
 
 void EdgeBasedGraphFactory::Run(const std::string &original_edge_data_filename,
-                                lua_State *lua_state,
+                                ScriptingEnvironment &scripting_environment,
                                 const std::string &edge_segment_lookup_filename,
                                 const std::string &edge_penalty_filename,
                                 const bool generate_edge_lookup)
@@ -187,8 +203,9 @@ void EdgeBasedGraphFactory::Run(const std::string &original_edge_data_filename,
     TIMER_STOP(generate_nodes);
 
     TIMER_START(generate_edges);
-    GenerateEdgeExpandedEdges(original_edge_data_filename, lua_state, edge_segment_lookup_filename,
-                              edge_penalty_filename, generate_edge_lookup);
+    GenerateEdgeExpandedEdges(original_edge_data_filename, scripting_environment,
+                              edge_segment_lookup_filename, edge_penalty_filename,
+                              generate_edge_lookup);
 
     TIMER_STOP(generate_edges);
 
@@ -281,17 +298,21 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
 }
 
 /// Actually it also generates OriginalEdgeData and serializes them...
+///
+/// Node-based nodes are expanded in fixed-size ranges: ranges are processed in parallel,
+/// each thread using its own lua state for the turn function, and their results are merged
+/// in node order so the edge ids and the written files do not depend on scheduling.
 void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     const std::string &original_edge_data_filename,
-    lua_State *lua_state,
+    ScriptingEnvironment &scripting_environment,
     const std::string &edge_segment_lookup_filename,
     const std::string &edge_fixed_penalties_filename,
     const bool generate_edge_lookup)
 {
     util::SimpleLogger().Write() << "generating edge-expanded edges";
 
-    BOOST_ASSERT(lua_state != nullptr);
-    const bool use_turn_function = util::luaFunctionExists(lua_state, "turn_function");
+    const bool use_turn_function =
+        util::luaFunctionExists(scripting_environment.GetContex().state, "turn_function");
 
     std::size_t node_based_edge_counter = 0;
     std::size_t original_edges_counter = 0;
@@ -317,125 +338,208 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     std::vector<OriginalEdgeData> original_edge_data_vector;
     original_edge_data_vector.reserve(1024 * 1024);
 
-    // Loop over all turns and generate new set of edges.
-    // Three nested loop look super-linear, but we are dealing with a (kind of)
-    // linear number of turns only.
-    util::Percent progress(m_node_based_graph->GetNumberOfNodes());
-    guidance::TurnAnalysis turn_analysis(*m_node_based_graph, m_node_info_list, *m_restriction_map,
-                                         m_barrier_nodes, m_compressed_edge_container, name_table);
-    for (const auto node_u : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
+    // Everything generated for one range of node-based nodes, in the order the serial
+    // implementation would have written it.
+    struct EdgeExpansionResult
     {
-        // progress.printStatus(node_u);
-        for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
-        {
-            if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
-            {
-                continue;
-            }
-
-            ++node_based_edge_counter;
-            auto possible_turns = turn_analysis.getTurns(node_u, edge_from_u);
+        NodeID begin_node;
+        NodeID end_node;
+        std::size_t node_based_edges = 0;
+        // edge ids are assigned when merging, they are the position in the final edge list
+        std::vector<EdgeBasedEdge> edges;
+        std::vector<OriginalEdgeData> original_edge_data;
+        std::vector<unsigned> fixed_penalties;
+        std::vector<char> segment_lookup;
+    };
+    using EdgeExpansionResultPtr = std::shared_ptr<EdgeExpansionResult>;
 
-            const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    const NodeID NODES_PER_RANGE = 4 * 1024;
+    NodeID next_range_begin = 0;
 
-            for (const auto turn : possible_turns)
+    // Turn penalties are looked up in a table sampled from the turn function, unless the
+    // profile asks for it to be called for every turn.
+    std::unique_ptr<TurnPenaltyTable> turn_penalty_table;
+    if (use_turn_function && profile_properties.use_turn_penalty_table)
+    {
+        lua_State *lua_state = scripting_environment.GetContex().state;
+        turn_penalty_table = util::make_unique<TurnPenaltyTable>(
+            [this, lua_state](const double angle)
             {
-                const double turn_angle = turn.angle;
-
-                // only add an edge if turn is not prohibited
-                const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
-                const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+                return GetTurnPenalty(angle, lua_state);
+            });
+    }
 
-                BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
-                BOOST_ASSERT(!edge_data1.reversed);
-                BOOST_ASSERT(!edge_data2.reversed);
+    // TurnAnalysis only reads the graph and its side data, so the threads can share it
+    const guidance::TurnAnalysis turn_analysis(*m_node_based_graph, m_node_info_list,
+                                               *m_restriction_map, m_barrier_nodes,
+                                               m_compressed_edge_container, name_table);
 
-                // the following is the core of the loop.
-                unsigned distance = edge_data1.distance;
-                if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
-                {
-                    distance += profile_properties.traffic_signal_penalty;
-                }
+    const auto partition_nodes = tbb::make_filter<void, EdgeExpansionResultPtr>(
+        tbb::filter::serial_in_order, [&](tbb::flow_control &flow_control)
+        {
+            if (next_range_begin >= number_of_nodes)
+            {
+                flow_control.stop();
+                return EdgeExpansionResultPtr{};
+            }
+            auto result = std::make_shared<EdgeExpansionResult>();
+            result->begin_node = next_range_begin;
+            result->end_node = std::min(number_of_nodes, next_range_begin + NODES_PER_RANGE);
+            next_range_begin = result->end_node;
+            return result;
+        });
 
-                const int turn_penalty =
-                    use_turn_function ? GetTurnPenalty(turn_angle, lua_state) : 0;
-                const auto turn_instruction = turn.instruction;
+    // Loop over all turns and generate new set of edges.
+    // Three nested loop look super-linear, but we are dealing with a (kind of)
+    // linear number of turns only.
+    const auto expand_nodes = tbb::make_filter<EdgeExpansionResultPtr, EdgeExpansionResultPtr>(
+        tbb::filter::parallel, [&](EdgeExpansionResultPtr result)
+        {
+            lua_State *lua_state = scripting_environment.GetContex().state;
 
-                if (guidance::isUturn(turn_instruction))
+            for (const auto node_u : util::irange(result->begin_node, result->end_node))
+            {
+                for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
                 {
-                    distance += profile_properties.u_turn_penalty;
-                }
-
-                distance += turn_penalty;
+                    if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
+                    {
+                        continue;
+                    }
 
-                BOOST_ASSERT(m_compressed_edge_container.HasEntryForID(edge_from_u));
-                original_edge_data_vector.emplace_back(
-                    m_compressed_edge_container.GetPositionForID(edge_from_u), edge_data1.name_id,
-                    turn_instruction, edge_data1.travel_mode);
+                    ++result->node_based_edges;
+                    auto possible_turns = turn_analysis.getTurns(node_u, edge_from_u);
 
-                ++original_edges_counter;
+                    const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
 
-                if (original_edge_data_vector.size() > 1024 * 1024 * 10)
-                {
-                    FlushVectorToStream(edge_data_file, original_edge_data_vector);
+                    for (const auto turn : possible_turns)
+                    {
+                        const double turn_angle = turn.angle;
+
+                        // only add an edge if turn is not prohibited
+                        const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
+                        const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+
+                        BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
+                        BOOST_ASSERT(!edge_data1.reversed);
+                        BOOST_ASSERT(!edge_data2.reversed);
+
+                        // the following is the core of the loop.
+                        unsigned distance = edge_data1.distance;
+                        if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
+                        {
+                            distance += profile_properties.traffic_signal_penalty;
+                        }
+
+                        int turn_penalty = 0;
+                        if (turn_penalty_table)
+                        {
+                            turn_penalty = turn_penalty_table->GetPenalty(turn_angle);
+                        }
+                        else if (use_turn_function)
+                        {
+                            turn_penalty = GetTurnPenalty(turn_angle, lua_state);
+                        }
+                        const auto turn_instruction = turn.instruction;
+
+                        if (guidance::isUturn(turn_instruction))
+                        {
+                            distance += profile_properties.u_turn_penalty;
+                        }
+
+                        distance += turn_penalty;
+
+                        BOOST_ASSERT(m_compressed_edge_container.HasEntryForID(edge_from_u));
+                        result->original_edge_data.emplace_back(
+                            m_compressed_edge_container.GetPositionForID(edge_from_u),
+                            edge_data1.name_id, turn_instruction, edge_data1.travel_mode);
+
+                        BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
+                        BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+
+                        result->edges.emplace_back(edge_data1.edge_id, edge_data2.edge_id,
+                                                   SPECIAL_EDGEID, distance, true, false);
+
+                        // Here is where we write out the mapping between the edge-expanded
+                        // edges, and the node-based edges that are originally used to calculate
+                        // the `distance` for the edge-expanded edges.  About 40 lines back,
+                        // there is:
+                        //
+                        //                 unsigned distance = edge_data1.distance;
+                        //
+                        // This tells us that the weight for an edge-expanded-edge is based on
+                        // the weight of the *source* node-based edge.  Therefore, we will look up
+                        // the individual segments of the source node-based edge, and write out a
+                        // mapping between those and the edge-based-edge ID.
+                        // External programs can then use this mapping to quickly perform
+                        // updates to the edge-expanded-edge based directly on its ID.
+                        if (generate_edge_lookup)
+                        {
+                            result->fixed_penalties.push_back(distance - edge_data1.distance);
+                            const auto node_based_edges =
+                                m_compressed_edge_container.GetBucketReference(edge_from_u);
+                            NodeID previous = node_u;
+
+                            auto &segment_lookup = result->segment_lookup;
+                            const unsigned node_count = node_based_edges.size() + 1;
+                            appendBytes(segment_lookup, node_count);
+                            const QueryNode &first_node = m_node_info_list[previous];
+                            appendBytes(segment_lookup, first_node.node_id);
+
+                            for (auto target_node : node_based_edges)
+                            {
+                                const QueryNode &from = m_node_info_list[previous];
+                                const QueryNode &to = m_node_info_list[target_node.node_id];
+                                const double segment_length =
+                                    util::coordinate_calculation::greatCircleDistance(from, to);
+
+                                appendBytes(segment_lookup, to.node_id);
+                                appendBytes(segment_lookup, segment_length);
+                                appendBytes(segment_lookup, target_node.weight);
+                                previous = target_node.node_id;
+                            }
+                        }
+                    }
                 }
+            }
+            return result;
+        });
 
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+    const auto merge_results = tbb::make_filter<EdgeExpansionResultPtr, void>(
+        tbb::filter::serial_in_order, [&](EdgeExpansionResultPtr result)
+        {
+            node_based_edge_counter += result->node_based_edges;
+            original_edges_counter += result->original_edge_data.size();
 
+            for (auto &edge : result->edges)
+            {
                 // NOTE: potential overflow here if we hit 2^32 routable edges
                 BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
-                m_edge_based_edge_list.emplace_back(edge_data1.edge_id, edge_data2.edge_id,
-                                                    m_edge_based_edge_list.size(), distance, true,
-                                                    false);
-
-                // Here is where we write out the mapping between the edge-expanded edges, and
-                // the node-based edges that are originally used to calculate the `distance`
-                // for the edge-expanded edges.  About 40 lines back, there is:
-                //
-                //                 unsigned distance = edge_data1.distance;
-                //
-                // This tells us that the weight for an edge-expanded-edge is based on the weight
-                // of the *source* node-based edge.  Therefore, we will look up the individual
-                // segments of the source node-based edge, and write out a mapping between
-                // those and the edge-based-edge ID.
-                // External programs can then use this mapping to quickly perform
-                // updates to the edge-expanded-edge based directly on its ID.
-                if (generate_edge_lookup)
-                {
-                    unsigned fixed_penalty = distance - edge_data1.distance;
-                    edge_penalty_file.write(reinterpret_cast<const char *>(&fixed_penalty),
-                                            sizeof(fixed_penalty));
-                    const auto node_based_edges =
-                        m_compressed_edge_container.GetBucketReference(edge_from_u);
-                    NodeID previous = node_u;
-
-                    const unsigned node_count = node_based_edges.size() + 1;
-                    edge_segment_file.write(reinterpret_cast<const char *>(&node_count),
-                                            sizeof(node_count));
-                    const QueryNode &first_node = m_node_info_list[previous];
-                    edge_segment_file.write(reinterpret_cast<const char *>(&first_node.node_id),
-                                            sizeof(first_node.node_id));
-
-                    for (auto target_node : node_based_edges)
-                    {
-                        const QueryNode &from = m_node_info_list[previous];
-                        const QueryNode &to = m_node_info_list[target_node.node_id];
-                        const double segment_length =
-                            util::coordinate_calculation::greatCircleDistance(from, to);
-
-                        edge_segment_file.write(reinterpret_cast<const char *>(&to.node_id),
-                                                sizeof(to.node_id));
-                        edge_segment_file.write(reinterpret_cast<const char *>(&segment_length),
-                                                sizeof(segment_length));
-                        edge_segment_file.write(reinterpret_cast<const char *>(&target_node.weight),
-                                                sizeof(target_node.weight));
-                        previous = target_node.node_id;
-                    }
-                }
+                edge.edge_id = m_edge_based_edge_list.size();
+                m_edge_based_edge_list.push_back(edge);
             }
-        }
-    }
+
+            original_edge_data_vector.insert(original_edge_data_vector.end(),
+                                             result->original_edge_data.begin(),
+                                             result->original_edge_data.end());
+            if (original_edge_data_vector.size() > 1024 * 1024 * 10)
+            {
+                FlushVectorToStream(edge_data_file, original_edge_data_vector);
+            }
+
+            if (generate_edge_lookup)
+            {
+                edge_penalty_file.write(
+                    reinterpret_cast<const char *>(result->fixed_penalties.data()),
+                    result->fixed_penalties.size() * sizeof(unsigned));
+                edge_segment_file.write(result->segment_lookup.data(),
+                                        result->segment_lookup.size());
+            }
+        });
+
+    // bounds the number of node ranges whose results are held in memory at once
+    const auto max_ranges_in_flight = 4 * tbb::task_scheduler_init::default_num_threads();
+    tbb::parallel_pipeline(max_ranges_in_flight, partition_nodes & expand_nodes & merge_results);
 
     FlushVectorToStream(edge_data_file, original_edge_data_vector);
 
@@ -1,5 +1,6 @@
 #include "extractor/extraction_containers.hpp"
 #include "extractor/extraction_way.hpp"
+#include "extractor/hybrid_sort.hpp"
 
 #include "util/coordinate_calculation.hpp"
 #include "util/range_table.hpp"
@@ -18,10 +19,13 @@
 
 #include <luabind/luabind.hpp>
 
-#include <stxxl/sort>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
+#include <vector>
 
 namespace
 {
@@ -41,14 +45,88 @@ namespace osrm
 namespace extractor
 {
 
-static const int WRITE_BLOCK_BUFFER_SIZE = 8000;
+static const std::size_t JOIN_BLOCK_SIZE = 1024 * 1024;
 
-ExtractionContainers::ExtractionContainers()
+namespace
+{
+// Merge-joins edges sorted by the node id returned from get_node_id with the nodes sorted by id.
+// Both lists are streamed block-wise from external memory: for every block of edges the nodes
+// spanning its id range are read into memory and each edge looks up its node by binary search,
+// which lets the edges of a block be joined in parallel. Edges without a node get a nullptr.
+template <typename GetNodeID, typename JoinFunction>
+void joinEdgesWithNodes(ExtractionContainers::STXXLEdgeVector &edges,
+                        const ExtractionContainers::STXXLNodeVector &nodes,
+                        const GetNodeID get_node_id,
+                        const JoinFunction join,
+                        const bool parallel)
+{
+    std::vector<InternalExtractorEdge> edge_block;
+    std::vector<ExternalMemoryNode> node_block;
+    edge_block.reserve(JOIN_BLOCK_SIZE);
+
+    auto node_iterator = nodes.begin();
+    const auto nodes_end = nodes.end();
+
+    for (std::size_t block_begin = 0; block_begin < edges.size(); block_begin += JOIN_BLOCK_SIZE)
+    {
+        const std::size_t block_end =
+            std::min<std::size_t>(edges.size(), block_begin + JOIN_BLOCK_SIZE);
+        edge_block.assign(edges.begin() + block_begin, edges.begin() + block_end);
+
+        const OSMNodeID first_id = get_node_id(edge_block.front());
+        const OSMNodeID last_id = get_node_id(edge_block.back());
+        while (node_iterator != nodes_end && node_iterator->node_id < first_id)
+        {
+            ++node_iterator;
+        }
+        node_block.clear();
+        for (auto iter = node_iterator; iter != nodes_end && iter->node_id <= last_id; ++iter)
+        {
+            node_block.push_back(*iter);
+        }
+        // the next block may start with last_id again
+        while (node_iterator != nodes_end && node_iterator->node_id < last_id)
+        {
+            ++node_iterator;
+        }
+
+        const auto join_range = [&](const tbb::blocked_range<std::size_t> &range)
+        {
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                auto &edge = edge_block[index];
+                const OSMNodeID node_id = get_node_id(edge);
+                const auto node = std::lower_bound(
+                    node_block.begin(), node_block.end(), node_id,
+                    [](const ExternalMemoryNode &lhs, const OSMNodeID rhs)
+                    {
+                        return lhs.node_id < rhs;
+                    });
+                const bool found = node != node_block.end() && node->node_id == node_id;
+                join(edge, found ? &*node : nullptr);
+            }
+        };
+
+        const tbb::blocked_range<std::size_t> block_range(0, edge_block.size());
+        if (parallel)
+        {
+            tbb::parallel_for(block_range, join_range);
+        }
+        else
+        {
+            join_range(block_range);
+        }
+
+        std::copy(edge_block.begin(), edge_block.end(), edges.begin() + block_begin);
+    }
+}
+}
+
+ExtractionContainers::ExtractionContainers(const std::size_t sort_memory_budget)
+    : sort_memory_budget(sort_memory_budget)
 {
     // Check if stxxl can be instantiated
     stxxl::vector<unsigned> dummy_vector;
-    // Insert the empty string, it has no data and is zero length
-    name_lengths.push_back(0);
 }
 
 ExtractionContainers::~ExtractionContainers()
@@ -57,8 +135,6 @@ ExtractionContainers::~ExtractionContainers()
     used_node_id_list.clear();
     all_nodes_list.clear();
     all_edges_list.clear();
-    name_char_data.clear();
-    name_lengths.clear();
     restrictions_list.clear();
     way_start_end_id_list.clear();
 }
@@ -107,6 +183,7 @@ void ExtractionContainers::WriteNames(const std::string &names_file_name) const
     TIMER_START(write_name_index);
     boost::filesystem::ofstream name_file_stream(names_file_name, std::ios::binary);
 
+    const auto name_lengths = name_interner.GetNameLengths();
     unsigned total_length = 0;
 
     for (const unsigned &name_length : name_lengths)
@@ -121,21 +198,7 @@ void ExtractionContainers::WriteNames(const std::string &names_file_name) const
     name_file_stream.write((char *)&total_length, sizeof(unsigned));
 
     // write all chars consecutively
-    char write_buffer[WRITE_BLOCK_BUFFER_SIZE];
-    unsigned buffer_len = 0;
-
-    for (const char &c : name_char_data)
-    {
-        write_buffer[buffer_len++] = c;
-
-        if (buffer_len >= WRITE_BLOCK_BUFFER_SIZE)
-        {
-            name_file_stream.write(write_buffer, WRITE_BLOCK_BUFFER_SIZE);
-            buffer_len = 0;
-        }
-    }
-
-    name_file_stream.write(write_buffer, buffer_len);
+    name_interner.WriteNameData(name_file_stream);
 
     TIMER_STOP(write_name_index);
     std::cout << "ok, after " << TIMER_SEC(write_name_index) << "s" << std::endl;
@@ -145,8 +208,7 @@ void ExtractionContainers::PrepareNodes()
 {
     std::cout << "[extractor] Sorting used nodes        ... " << std::flush;
     TIMER_START(sorting_used_nodes);
-    stxxl::sort(used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess(),
-                stxxl_memory);
+    hybridSort(used_node_id_list, OSMNodeIDSTXXLLess(), sort_memory_budget, stxxl_memory);
     TIMER_STOP(sorting_used_nodes);
     std::cout << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s" << std::endl;
 
@@ -159,8 +221,8 @@ void ExtractionContainers::PrepareNodes()
 
     std::cout << "[extractor] Sorting all nodes         ... " << std::flush;
     TIMER_START(sorting_nodes);
-    stxxl::sort(all_nodes_list.begin(), all_nodes_list.end(), ExternalMemoryNodeSTXXLCompare(),
-                stxxl_memory);
+    hybridSort(all_nodes_list, ExternalMemoryNodeSTXXLCompare(), sort_memory_budget,
+               stxxl_memory);
     TIMER_STOP(sorting_nodes);
     std::cout << "ok, after " << TIMER_SEC(sorting_nodes) << "s" << std::endl;
 
@@ -210,184 +272,152 @@ void ExtractionContainers::PrepareEdges(lua_State *segment_state)
     // Sort edges by start.
     std::cout << "[extractor] Sorting edges by start    ... " << std::flush;
     TIMER_START(sort_edges_by_start);
-    stxxl::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID(), stxxl_memory);
+    hybridSort(all_edges_list, CmpEdgeByOSMStartID(), sort_memory_budget, stxxl_memory);
     TIMER_STOP(sort_edges_by_start);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s" << std::endl;
 
     std::cout << "[extractor] Setting start coords      ... " << std::flush;
     TIMER_START(set_start_coords);
-    // Traverse list of edges and nodes in parallel and set start coord
-    auto node_iterator = all_nodes_list.begin();
-    auto edge_iterator = all_edges_list.begin();
-
-    const auto all_edges_list_end = all_edges_list.end();
-    const auto all_nodes_list_end = all_nodes_list.end();
-
-    while (edge_iterator != all_edges_list_end && node_iterator != all_nodes_list_end)
-    {
-        if (edge_iterator->result.osm_source_id < node_iterator->node_id)
-        {
-            util::SimpleLogger().Write(LogLevel::logWARNING) << "Found invalid node reference "
-                                                             << edge_iterator->result.source;
-            edge_iterator->result.source = SPECIAL_NODEID;
-            ++edge_iterator;
-            continue;
-        }
-        if (edge_iterator->result.osm_source_id > node_iterator->node_id)
-        {
-            node_iterator++;
-            continue;
-        }
-
-        // remove loops
-        if (edge_iterator->result.osm_source_id == edge_iterator->result.osm_target_id)
-        {
-            edge_iterator->result.source = SPECIAL_NODEID;
-            edge_iterator->result.target = SPECIAL_NODEID;
-            ++edge_iterator;
-            continue;
-        }
-
-        BOOST_ASSERT(edge_iterator->result.osm_source_id == node_iterator->node_id);
-
-        // assign new node id
-        auto id_iter = external_to_internal_node_id_map.find(node_iterator->node_id);
-        BOOST_ASSERT(id_iter != external_to_internal_node_id_map.end());
-        edge_iterator->result.source = id_iter->second;
-
-        edge_iterator->source_coordinate.lat = node_iterator->lat;
-        edge_iterator->source_coordinate.lon = node_iterator->lon;
-        ++edge_iterator;
-    }
-
-    // Remove all remaining edges. They are invalid because there are no corresponding nodes for
-    // them. This happens when using osmosis with bbox or polygon to extract smaller areas.
-    auto markSourcesInvalid = [](InternalExtractorEdge &edge)
-    {
-        util::SimpleLogger().Write(LogLevel::logWARNING) << "Found invalid node reference "
-                                                         << edge.result.source;
-        edge.result.source = SPECIAL_NODEID;
-        edge.result.osm_source_id = SPECIAL_OSM_NODEID;
-    };
-    std::for_each(edge_iterator, all_edges_list_end, markSourcesInvalid);
+    // Join edges and nodes on the start node and set start coord
+    joinEdgesWithNodes(all_edges_list, all_nodes_list,
+                       [](const InternalExtractorEdge &edge)
+                       {
+                           return edge.result.osm_source_id;
+                       },
+                       [this](InternalExtractorEdge &edge, const ExternalMemoryNode *node)
+                       {
+                           // Invalid because there is no corresponding node. This happens when
+                           // using osmosis with bbox or polygon to extract smaller areas.
+                           if (node == nullptr)
+                           {
+                               util::SimpleLogger().Write(LogLevel::logWARNING)
+                                   << "Found invalid node reference "
+                                   << static_cast<uint64_t>(edge.result.osm_source_id);
+                               edge.result.source = SPECIAL_NODEID;
+                               return;
+                           }
+
+                           // remove loops
+                           if (edge.result.osm_source_id == edge.result.osm_target_id)
+                           {
+                               edge.result.source = SPECIAL_NODEID;
+                               edge.result.target = SPECIAL_NODEID;
+                               return;
+                           }
+
+                           // assign new node id
+                           auto id_iter = external_to_internal_node_id_map.find(node->node_id);
+                           BOOST_ASSERT(id_iter != external_to_internal_node_id_map.end());
+                           edge.result.source = id_iter->second;
+
+                           edge.source_coordinate.lat = node->lat;
+                           edge.source_coordinate.lon = node->lon;
+                       },
+                       true);
     TIMER_STOP(set_start_coords);
     std::cout << "ok, after " << TIMER_SEC(set_start_coords) << "s" << std::endl;
 
     // Sort Edges by target
     std::cout << "[extractor] Sorting edges by target   ... " << std::flush;
     TIMER_START(sort_edges_by_target);
-    stxxl::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID(), stxxl_memory);
+    hybridSort(all_edges_list, CmpEdgeByOSMTargetID(), sort_memory_budget, stxxl_memory);
     TIMER_STOP(sort_edges_by_target);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s" << std::endl;
 
     // Compute edge weights
     std::cout << "[extractor] Computing edge weights    ... " << std::flush;
     TIMER_START(compute_weights);
-    node_iterator = all_nodes_list.begin();
-    edge_iterator = all_edges_list.begin();
-    const auto all_edges_list_end_ = all_edges_list.end();
-    const auto all_nodes_list_end_ = all_nodes_list.end();
 
+    // the segment function may use raster sources, which are only loaded into this lua state
     const auto has_segment_function = util::luaFunctionExists(segment_state, "segment_function");
 
-    while (edge_iterator != all_edges_list_end_ && node_iterator != all_nodes_list_end_)
-    {
-        // skip all invalid edges
-        if (edge_iterator->result.source == SPECIAL_NODEID)
-        {
-            ++edge_iterator;
-            continue;
-        }
-
-        if (edge_iterator->result.osm_target_id < node_iterator->node_id)
-        {
-            util::SimpleLogger().Write(LogLevel::logWARNING)
-                << "Found invalid node reference "
-                << static_cast<uint64_t>(edge_iterator->result.osm_target_id);
-            edge_iterator->result.target = SPECIAL_NODEID;
-            ++edge_iterator;
-            continue;
-        }
-        if (edge_iterator->result.osm_target_id > node_iterator->node_id)
+    joinEdgesWithNodes(
+        all_edges_list, all_nodes_list,
+        [](const InternalExtractorEdge &edge)
         {
-            ++node_iterator;
-            continue;
-        }
-
-        BOOST_ASSERT(edge_iterator->result.osm_target_id == node_iterator->node_id);
-        BOOST_ASSERT(edge_iterator->weight_data.speed >= 0);
-        BOOST_ASSERT(edge_iterator->source_coordinate.lat !=
-                     util::FixedLatitude(std::numeric_limits<int>::min()));
-        BOOST_ASSERT(edge_iterator->source_coordinate.lon !=
-                     util::FixedLongitude(std::numeric_limits<int>::min()));
-
-        const double distance = util::coordinate_calculation::greatCircleDistance(
-            edge_iterator->source_coordinate,
-            util::Coordinate(node_iterator->lon, node_iterator->lat));
-
-        if (has_segment_function)
+            return edge.result.osm_target_id;
+        },
+        [&](InternalExtractorEdge &edge, const ExternalMemoryNode *node)
         {
-            luabind::call_function<void>(
-                segment_state, "segment_function", boost::cref(edge_iterator->source_coordinate),
-                boost::cref(*node_iterator), distance, boost::ref(edge_iterator->weight_data));
-        }
+            // skip all invalid edges
+            if (edge.result.source == SPECIAL_NODEID)
+            {
+                return;
+            }
 
-        const double weight = [distance](const InternalExtractorEdge::WeightData &data)
-        {
-            switch (data.type)
+            // Invalid because there is no corresponding node. This happens when using osmosis
+            // with bbox or polygon to extract smaller areas.
+            if (node == nullptr)
             {
-            case InternalExtractorEdge::WeightType::EDGE_DURATION:
-            case InternalExtractorEdge::WeightType::WAY_DURATION:
-                return data.duration * 10.;
-                break;
-            case InternalExtractorEdge::WeightType::SPEED:
-                return (distance * 10.) / (data.speed / 3.6);
-                break;
-            case InternalExtractorEdge::WeightType::INVALID:
-                util::exception("invalid weight type");
+                util::SimpleLogger().Write(LogLevel::logWARNING)
+                    << "Found invalid node reference "
+                    << static_cast<uint64_t>(edge.result.osm_target_id);
+                edge.result.target = SPECIAL_NODEID;
+                return;
             }
-            return -1.0;
-        }(edge_iterator->weight_data);
 
-        auto &edge = edge_iterator->result;
-        edge.weight = std::max(1, static_cast<int>(std::floor(weight + .5)));
+            BOOST_ASSERT(edge.weight_data.speed >= 0);
+            BOOST_ASSERT(edge.source_coordinate.lat !=
+                         util::FixedLatitude(std::numeric_limits<int>::min()));
+            BOOST_ASSERT(edge.source_coordinate.lon !=
+                         util::FixedLongitude(std::numeric_limits<int>::min()));
 
-        // assign new node id
-        auto id_iter = external_to_internal_node_id_map.find(node_iterator->node_id);
-        BOOST_ASSERT(id_iter != external_to_internal_node_id_map.end());
-        edge.target = id_iter->second;
+            const double distance = util::coordinate_calculation::greatCircleDistance(
+                edge.source_coordinate, util::Coordinate(node->lon, node->lat));
 
-        // orient edges consistently: source id < target id
-        // important for multi-edge removal
-        if (edge.source > edge.target)
-        {
-            std::swap(edge.source, edge.target);
+            if (has_segment_function)
+            {
+                luabind::call_function<void>(
+                    segment_state, "segment_function", boost::cref(edge.source_coordinate),
+                    boost::cref(*node), distance, boost::ref(edge.weight_data));
+            }
 
-            // std::swap does not work with bit-fields
-            bool temp = edge.forward;
-            edge.forward = edge.backward;
-            edge.backward = temp;
-        }
-        ++edge_iterator;
-    }
+            const double weight = [distance](const InternalExtractorEdge::WeightData &data)
+            {
+                switch (data.type)
+                {
+                case InternalExtractorEdge::WeightType::EDGE_DURATION:
+                case InternalExtractorEdge::WeightType::WAY_DURATION:
+                    return data.duration * 10.;
+                    break;
+                case InternalExtractorEdge::WeightType::SPEED:
+                    return (distance * 10.) / (data.speed / 3.6);
+                    break;
+                case InternalExtractorEdge::WeightType::INVALID:
+                    util::exception("invalid weight type");
+                }
+                return -1.0;
+            }(edge.weight_data);
+
+            auto &result = edge.result;
+            result.weight = std::max(1, static_cast<int>(std::floor(weight + .5)));
+
+            // assign new node id
+            auto id_iter = external_to_internal_node_id_map.find(node->node_id);
+            BOOST_ASSERT(id_iter != external_to_internal_node_id_map.end());
+            result.target = id_iter->second;
+
+            // orient edges consistently: source id < target id
+            // important for multi-edge removal
+            if (result.source > result.target)
+            {
+                std::swap(result.source, result.target);
 
-    // Remove all remaining edges. They are invalid because there are no corresponding nodes for
-    // them. This happens when using osmosis with bbox or polygon to extract smaller areas.
-    auto markTargetsInvalid = [](InternalExtractorEdge &edge)
-    {
-        util::SimpleLogger().Write(LogLevel::logWARNING) << "Found invalid node reference "
-                                                         << edge.result.target;
-        edge.result.target = SPECIAL_NODEID;
-    };
-    std::for_each(edge_iterator, all_edges_list_end_, markTargetsInvalid);
+                // std::swap does not work with bit-fields
+                bool temp = result.forward;
+                result.forward = result.backward;
+                result.backward = temp;
+            }
+        },
+        !has_segment_function);
     TIMER_STOP(compute_weights);
     std::cout << "ok, after " << TIMER_SEC(compute_weights) << "s" << std::endl;
 
     // Sort edges by start.
     std::cout << "[extractor] Sorting edges by renumbered start ... " << std::flush;
     TIMER_START(sort_edges_by_renumbered_start);
-    stxxl::sort(all_edges_list.begin(), all_edges_list.end(),
-                CmpEdgeByInternalStartThenInternalTargetID(), stxxl_memory);
+    hybridSort(all_edges_list, CmpEdgeByInternalStartThenInternalTargetID(), sort_memory_budget,
+               stxxl_memory);
     TIMER_STOP(sort_edges_by_renumbered_start);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s" << std::endl;
 
@@ -480,16 +510,11 @@ void ExtractionContainers::PrepareEdges(lua_State *segment_state)
     }
 }
 
-void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream) const
+void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream)
 {
     std::cout << "[extractor] Writing used edges       ... " << std::flush;
     TIMER_START(write_edges);
-    // Traverse list of edges and nodes in parallel and set target coord
-    std::size_t used_edges_counter = 0;
-    unsigned used_edges_counter_buffer = 0;
-
-    auto start_position = file_out_stream.tellp();
-    file_out_stream.write((char *)&used_edges_counter_buffer, sizeof(unsigned));
+    auto &used_edges = node_based_graph_data.edges;
 
     for (const auto &edge : all_edges_list)
     {
@@ -498,32 +523,26 @@ void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream) const
             continue;
         }
 
-        // IMPORTANT: here, we're using slicing to only write the data from the base
+        // IMPORTANT: here, we're using slicing to only keep the data from the base
         // class of NodeBasedEdgeWithOSM
-        NodeBasedEdge tmp = edge.result;
-        file_out_stream.write((char *)&tmp, sizeof(NodeBasedEdge));
-        used_edges_counter++;
+        used_edges.push_back(edge.result);
     }
+    const std::size_t used_edges_counter = used_edges.size();
 
     if (used_edges_counter > std::numeric_limits<unsigned>::max())
     {
         throw util::exception("There are too many edges, OSRM only supports 2^32");
     }
+    const unsigned number_of_used_edges = boost::numeric_cast<unsigned>(used_edges_counter);
+    file_out_stream.write((char *)&number_of_used_edges, sizeof(unsigned));
+    file_out_stream.write((char *)used_edges.data(), used_edges_counter * sizeof(NodeBasedEdge));
     TIMER_STOP(write_edges);
     std::cout << "ok, after " << TIMER_SEC(write_edges) << "s" << std::endl;
 
-    std::cout << "[extractor] setting number of edges   ... " << std::flush;
-
-    used_edges_counter_buffer = boost::numeric_cast<unsigned>(used_edges_counter);
-
-    file_out_stream.seekp(start_position);
-    file_out_stream.write((char *)&used_edges_counter_buffer, sizeof(unsigned));
-    std::cout << "ok" << std::endl;
-
     util::SimpleLogger().Write() << "Processed " << used_edges_counter << " edges";
 }
 
-void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
+void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream)
 {
     // write dummy value, will be overwritten later
     std::cout << "[extractor] setting number of nodes   ... " << std::flush;
@@ -532,6 +551,7 @@ void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
 
     std::cout << "[extractor] Confirming/Writing used nodes     ... " << std::flush;
     TIMER_START(write_nodes);
+    node_based_graph_data.nodes.reserve(max_internal_node_id);
     // identify all used nodes by a merging step of two sorted lists
     auto node_iterator = all_nodes_list.begin();
     auto node_id_iterator = used_node_id_list.begin();
@@ -554,6 +574,18 @@ void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
 
         file_out_stream.write((char *)&(*node_iterator), sizeof(ExternalMemoryNode));
 
+        const auto internal_id = static_cast<NodeID>(node_based_graph_data.nodes.size());
+        node_based_graph_data.nodes.emplace_back(node_iterator->lon, node_iterator->lat,
+                                                 node_iterator->node_id);
+        if (node_iterator->barrier)
+        {
+            node_based_graph_data.barrier_nodes.push_back(internal_id);
+        }
+        if (node_iterator->traffic_lights)
+        {
+            node_based_graph_data.traffic_lights.push_back(internal_id);
+        }
+
         ++node_id_iterator;
         ++node_iterator;
     }
@@ -594,16 +626,16 @@ void ExtractionContainers::PrepareRestrictions()
 {
     std::cout << "[extractor] Sorting used ways         ... " << std::flush;
     TIMER_START(sort_ways);
-    stxxl::sort(way_start_end_id_list.begin(), way_start_end_id_list.end(),
-                FirstAndLastSegmentOfWayStxxlCompare(), stxxl_memory);
+    hybridSort(way_start_end_id_list, FirstAndLastSegmentOfWayStxxlCompare(), sort_memory_budget,
+               stxxl_memory);
     TIMER_STOP(sort_ways);
     std::cout << "ok, after " << TIMER_SEC(sort_ways) << "s" << std::endl;
 
     std::cout << "[extractor] Sorting " << restrictions_list.size() << " restriction. by from... "
               << std::flush;
     TIMER_START(sort_restrictions);
-    stxxl::sort(restrictions_list.begin(), restrictions_list.end(), CmpRestrictionContainerByFrom(),
-                stxxl_memory);
+    hybridSort(restrictions_list, CmpRestrictionContainerByFrom(), sort_memory_budget,
+               stxxl_memory);
     TIMER_STOP(sort_restrictions);
     std::cout << "ok, after " << TIMER_SEC(sort_restrictions) << "s" << std::endl;
 
@@ -694,8 +726,8 @@ void ExtractionContainers::PrepareRestrictions()
 
     std::cout << "[extractor] Sorting restrictions. by to  ... " << std::flush;
     TIMER_START(sort_restrictions_to);
-    stxxl::sort(restrictions_list.begin(), restrictions_list.end(), CmpRestrictionContainerByTo(),
-                stxxl_memory);
+    hybridSort(restrictions_list, CmpRestrictionContainerByTo(), sort_memory_budget,
+               stxxl_memory);
     TIMER_STOP(sort_restrictions_to);
     std::cout << "ok, after " << TIMER_SEC(sort_restrictions_to) << "s" << std::endl;
 
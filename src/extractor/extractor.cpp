@@ -24,7 +24,7 @@
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/restriction_map.hpp"
 
-#include "extractor/tarjan_scc.hpp"
+#include "extractor/parallel_scc.hpp"
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
@@ -34,7 +34,9 @@
 
 #include <osmium/io/any_input.hpp>
 
+#include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
+#include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
 #include <cstdlib>
@@ -44,6 +46,7 @@
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -79,6 +82,9 @@ int Extractor::run()
     // setup scripting environment
     ScriptingEnvironment scripting_environment(config.profile_path.string().c_str());
 
+    // handed from the extraction to the expansion stage
+    NodeBasedGraphData node_based_graph_data;
+
     try
     {
         util::LogPolicy::GetInstance().Unmute();
@@ -93,7 +99,8 @@ int Extractor::run()
         util::SimpleLogger().Write() << "Profile: " << config.profile_path.filename().string();
         util::SimpleLogger().Write() << "Threads: " << number_of_threads;
 
-        ExtractionContainers extraction_containers;
+        ExtractionContainers extraction_containers(
+            static_cast<std::size_t>(config.sort_memory_budget) * 1024 * 1024);
         auto extractor_callbacks = util::make_unique<ExtractorCallbacks>(extraction_containers);
 
         const osmium::io::File input_file(config.input_path.string());
@@ -116,6 +123,17 @@ int Extractor::run()
             luabind::call_function<void>(main_context.state, "source_function");
         }
 
+        for (const auto &filter : {std::make_pair("node", &main_context.node_tag_filter),
+                                   std::make_pair("way", &main_context.way_tag_filter)})
+        {
+            if (filter.second->IsActive())
+            {
+                util::SimpleLogger().Write()
+                    << "Profile inspects " << filter.second->GetKeys().size() << " " << filter.first
+                    << " tag keys, skipping " << filter.first << "s without them";
+            }
+        }
+
         std::string generator = header.get("generator");
         if (generator.empty())
         {
@@ -134,90 +152,134 @@ int Extractor::run()
         boost::filesystem::ofstream timestamp_out(config.timestamp_file_name);
         timestamp_out.write(timestamp.c_str(), timestamp.length());
 
-        // initialize vectors holding parsed objects
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
-        tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
-
         // setup restriction parser
         const RestrictionParser restriction_parser(main_context.state, main_context.properties);
 
-        while (const osmium::memory::Buffer buffer = reader.read())
+        // A buffer read from the input together with the results of running the profile on
+        // its entities. The results keep iterators into the buffer, so both travel together.
+        struct ParsedBuffer
         {
-            // create a vector of iterators into the buffer
+            osmium::memory::Buffer buffer;
             std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
-            for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
+            tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
+                resulting_restrictions;
+        };
+        using ParsedBufferPtr = std::shared_ptr<ParsedBuffer>;
+
+        // Reading (and decompressing), running the profile and feeding the results into the
+        // extraction containers overlap across buffers. Reading and ingestion stay serial and in
+        // order; the number of buffers in flight bounds the memory used for parsed results.
+        const auto max_buffers_in_flight = std::max(2u, number_of_threads);
+
+        const auto read_buffer = tbb::make_filter<void, ParsedBufferPtr>(
+            tbb::filter::serial_in_order, [&](tbb::flow_control &flow_control)
             {
-                osm_elements.push_back(iter);
-            }
-
-            // clear resulting vectors
-            resulting_nodes.clear();
-            resulting_ways.clear();
-            resulting_restrictions.clear();
-
-            // parse OSM entities in parallel, store in resulting vectors
-            tbb::parallel_for(
-                tbb::blocked_range<std::size_t>(0, osm_elements.size()),
-                [&](const tbb::blocked_range<std::size_t> &range)
+                auto parsed = std::make_shared<ParsedBuffer>();
+                parsed->buffer = reader.read();
+                if (!parsed->buffer)
+                {
+                    flow_control.stop();
+                    return ParsedBufferPtr{};
+                }
+                // create a vector of iterators into the buffer
+                const auto &buffer = parsed->buffer;
+                for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
                 {
-                    ExtractionNode result_node;
-                    ExtractionWay result_way;
-                    auto &local_context = scripting_environment.GetContex();
+                    parsed->osm_elements.push_back(iter);
+                }
+                return parsed;
+            });
 
-                    for (auto x = range.begin(), end = range.end(); x != end; ++x)
+        const auto run_profile = tbb::make_filter<ParsedBufferPtr, ParsedBufferPtr>(
+            tbb::filter::parallel, [&](ParsedBufferPtr parsed)
+            {
+                const auto &osm_elements = parsed->osm_elements;
+                // parse OSM entities in parallel, store in resulting vectors
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, osm_elements.size()),
+                    [&](const tbb::blocked_range<std::size_t> &range)
                     {
-                        const auto entity = osm_elements[x];
+                        ExtractionNode result_node;
+                        ExtractionWay result_way;
+                        auto &local_context = scripting_environment.GetContex();
 
-                        switch (entity->type())
+                        for (auto x = range.begin(), end = range.end(); x != end; ++x)
                         {
-                        case osmium::item_type::node:
-                            result_node.clear();
-                            ++number_of_nodes;
-                            luabind::call_function<void>(
-                                local_context.state, "node_function",
-                                boost::cref(static_cast<const osmium::Node &>(*entity)),
-                                boost::ref(result_node));
-                            resulting_nodes.push_back(std::make_pair(x, result_node));
-                            break;
-                        case osmium::item_type::way:
-                            result_way.clear();
-                            ++number_of_ways;
-                            luabind::call_function<void>(
-                                local_context.state, "way_function",
-                                boost::cref(static_cast<const osmium::Way &>(*entity)),
-                                boost::ref(result_way));
-                            resulting_ways.push_back(std::make_pair(x, result_way));
-                            break;
-                        case osmium::item_type::relation:
-                            ++number_of_relations;
-                            resulting_restrictions.push_back(restriction_parser.TryParse(
-                                static_cast<const osmium::Relation &>(*entity)));
-                            break;
-                        default:
-                            ++number_of_others;
-                            break;
+                            const auto entity = osm_elements[x];
+
+                            switch (entity->type())
+                            {
+                            case osmium::item_type::node:
+                                result_node.clear();
+                                ++number_of_nodes;
+                                // nodes without relevant tags keep the default result, but
+                                // still have to be passed on for their coordinates
+                                if (local_context.node_tag_filter.Matches(
+                                        static_cast<const osmium::Node &>(*entity).tags()))
+                                {
+                                    luabind::call_function<void>(
+                                        local_context.state, "node_function",
+                                        boost::cref(static_cast<const osmium::Node &>(*entity)),
+                                        boost::ref(result_node));
+                                }
+                                parsed->resulting_nodes.push_back(std::make_pair(x, result_node));
+                                break;
+                            case osmium::item_type::way:
+                                ++number_of_ways;
+                                // ways with the default result are dropped by the callbacks
+                                if (!local_context.way_tag_filter.Matches(
+                                        static_cast<const osmium::Way &>(*entity).tags()))
+                                {
+                                    break;
+                                }
+                                result_way.clear();
+                                luabind::call_function<void>(
+                                    local_context.state, "way_function",
+                                    boost::cref(static_cast<const osmium::Way &>(*entity)),
+                                    boost::ref(result_way));
+                                parsed->resulting_ways.push_back(std::make_pair(x, result_way));
+                                break;
+                            case osmium::item_type::relation:
+                                ++number_of_relations;
+                                parsed->resulting_restrictions.push_back(
+                                    restriction_parser.TryParse(
+                                        static_cast<const osmium::Relation &>(*entity)));
+                                break;
+                            default:
+                                ++number_of_others;
+                                break;
+                            }
                         }
-                    }
-                });
+                    });
+                return parsed;
+            });
 
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : resulting_nodes)
-            {
-                extractor_callbacks->ProcessNode(
-                    static_cast<const osmium::Node &>(*(osm_elements[result.first])),
-                    result.second);
-            }
-            for (const auto &result : resulting_ways)
+        const auto ingest_results = tbb::make_filter<ParsedBufferPtr, void>(
+            tbb::filter::serial_in_order, [&](ParsedBufferPtr parsed)
             {
-                extractor_callbacks->ProcessWay(
-                    static_cast<const osmium::Way &>(*(osm_elements[result.first])), result.second);
-            }
-            for (const auto &result : resulting_restrictions)
-            {
-                extractor_callbacks->ProcessRestriction(result);
-            }
-        }
+                const auto &osm_elements = parsed->osm_elements;
+                // put parsed objects thru extractor callbacks
+                for (const auto &result : parsed->resulting_nodes)
+                {
+                    extractor_callbacks->ProcessNode(
+                        static_cast<const osmium::Node &>(*(osm_elements[result.first])),
+                        result.second);
+                }
+                for (const auto &result : parsed->resulting_ways)
+                {
+                    extractor_callbacks->ProcessWay(
+                        static_cast<const osmium::Way &>(*(osm_elements[result.first])),
+                        result.second);
+                }
+                for (const auto &result : parsed->resulting_restrictions)
+                {
+                    extractor_callbacks->ProcessRestriction(result);
+                }
+            });
+
+        tbb::parallel_pipeline(max_buffers_in_flight, read_buffer & run_profile & ingest_results);
         TIMER_STOP(parsing);
         util::SimpleLogger().Write() << "Parsing finished after " << TIMER_SEC(parsing)
                                      << " seconds";
@@ -237,6 +299,7 @@ int Extractor::run()
 
         extraction_containers.PrepareData(config.output_file_name, config.restriction_file_name,
                                           config.names_file_name, main_context.state);
+        node_based_graph_data = std::move(extraction_containers.node_based_graph_data);
 
         WriteProfileProperties(config.profile_properties_output_path, main_context.properties);
 
@@ -269,7 +332,8 @@ int Extractor::run()
         std::vector<bool> node_is_startpoint;
         std::vector<EdgeWeight> edge_based_node_weights;
         std::vector<QueryNode> internal_to_external_node_map;
-        auto graph_size = BuildEdgeExpandedGraph(main_context.state, main_context.properties,
+        auto graph_size = BuildEdgeExpandedGraph(std::move(node_based_graph_data),
+                                                 scripting_environment, main_context.properties,
                                                  internal_to_external_node_map,
                                                  edge_based_node_list, node_is_startpoint,
                                                  edge_based_node_weights, edge_based_edge_list);
@@ -390,7 +454,7 @@ void Extractor::FindComponents(unsigned max_edge_id,
 
     auto uncontractor_graph = std::make_shared<UncontractedGraph>(max_edge_id + 1, edges);
 
-    TarjanSCC<UncontractedGraph> component_search(
+    ParallelSCC<UncontractedGraph> component_search(
         std::const_pointer_cast<const UncontractedGraph>(uncontractor_graph));
     component_search.run();
 
@@ -424,51 +488,42 @@ std::shared_ptr<RestrictionMap> Extractor::LoadRestrictionMap()
 }
 
 /**
-  \brief Load node based graph from .osrm file
+  \brief Build node based graph from the nodes and edges handed over by the extraction,
+  which are the same as written to the .osrm file
   */
 std::shared_ptr<util::NodeBasedDynamicGraph>
-Extractor::LoadNodeBasedGraph(std::unordered_set<NodeID> &barrier_nodes,
+Extractor::LoadNodeBasedGraph(NodeBasedGraphData graph_data,
+                              std::unordered_set<NodeID> &barrier_nodes,
                               std::unordered_set<NodeID> &traffic_lights,
                               std::vector<QueryNode> &internal_to_external_node_map)
 {
-    std::vector<NodeBasedEdge> edge_list;
-
-    boost::filesystem::ifstream input_stream(config.output_file_name,
-                                             std::ios::in | std::ios::binary);
+    const NodeID number_of_node_based_nodes = graph_data.nodes.size();
+    internal_to_external_node_map = std::move(graph_data.nodes);
 
-    std::vector<NodeID> barrier_list;
-    std::vector<NodeID> traffic_light_list;
-    NodeID number_of_node_based_nodes = util::loadNodesFromFile(
-        input_stream, barrier_list, traffic_light_list, internal_to_external_node_map);
-
-    util::SimpleLogger().Write() << " - " << barrier_list.size() << " bollard nodes, "
-                                 << traffic_light_list.size() << " traffic lights";
+    util::SimpleLogger().Write() << "Importing n = " << number_of_node_based_nodes
+                                 << " nodes and " << graph_data.edges.size() << " edges";
+    util::SimpleLogger().Write() << " - " << graph_data.barrier_nodes.size() << " bollard nodes, "
+                                 << graph_data.traffic_lights.size() << " traffic lights";
 
     // insert into unordered sets for fast lookup
-    barrier_nodes.insert(barrier_list.begin(), barrier_list.end());
-    traffic_lights.insert(traffic_light_list.begin(), traffic_light_list.end());
-
-    barrier_list.clear();
-    barrier_list.shrink_to_fit();
-    traffic_light_list.clear();
-    traffic_light_list.shrink_to_fit();
-
-    util::loadEdgesFromFile(input_stream, edge_list);
+    barrier_nodes.insert(graph_data.barrier_nodes.begin(), graph_data.barrier_nodes.end());
+    traffic_lights.insert(graph_data.traffic_lights.begin(), graph_data.traffic_lights.end());
 
-    if (edge_list.empty())
+    if (graph_data.edges.empty())
     {
         util::SimpleLogger().Write(logWARNING) << "The input data is empty, exiting.";
         return std::shared_ptr<util::NodeBasedDynamicGraph>();
     }
 
-    return util::NodeBasedDynamicGraphFromEdges(number_of_node_based_nodes, edge_list);
+    return util::NodeBasedDynamicGraphFromEdges(number_of_node_based_nodes, graph_data.edges);
 }
 
 /**
  \brief Building an edge-expanded graph from node-based input and turn restrictions
 */
 std::pair<std::size_t, std::size_t>
-Extractor::BuildEdgeExpandedGraph(lua_State *lua_state,
+Extractor::BuildEdgeExpandedGraph(NodeBasedGraphData node_based_graph_data,
+                                  ScriptingEnvironment &scripting_environment,
                                   const ProfileProperties &profile_properties,
                                   std::vector<QueryNode> &internal_to_external_node_map,
                                   std::vector<EdgeBasedNode> &node_based_edge_list,
@@ -480,8 +535,8 @@ Extractor::BuildEdgeExpandedGraph(lua_State *lua_state,
     std::unordered_set<NodeID> traffic_lights;
 
     auto restriction_map = LoadRestrictionMap();
-    auto node_based_graph =
-        LoadNodeBasedGraph(barrier_nodes, traffic_lights, internal_to_external_node_map);
+    auto node_based_graph = LoadNodeBasedGraph(std::move(node_based_graph_data), barrier_nodes,
+                                               traffic_lights, internal_to_external_node_map);
 
     CompressedEdgeContainer compressed_edge_container;
     GraphCompressor graph_compressor;
@@ -497,7 +552,7 @@ Extractor::BuildEdgeExpandedGraph(lua_State *lua_state,
         std::const_pointer_cast<RestrictionMap const>(restriction_map),
         internal_to_external_node_map, profile_properties, name_table);
 
-    edge_based_graph_factory.Run(config.edge_output_path, lua_state,
+    edge_based_graph_factory.Run(config.edge_output_path, scripting_environment,
                                  config.edge_segment_lookup_path, config.edge_penalty_path,
                                  config.generate_edge_lookup);
 
@@ -26,7 +26,6 @@ namespace extractor
 ExtractorCallbacks::ExtractorCallbacks(ExtractionContainers &extraction_containers)
     : external_memory(extraction_containers)
 {
-    string_map[""] = 0;
 }
 
 /**
@@ -137,20 +136,7 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
     }
 
     // Get the unique identifier for the street name
-    const auto &string_map_iterator = string_map.find(parsed_way.name);
-    unsigned name_id = external_memory.name_lengths.size();
-    if (string_map.end() == string_map_iterator)
-    {
-        auto name_length = std::min<unsigned>(255u, parsed_way.name.size());
-        std::copy(parsed_way.name.c_str(), parsed_way.name.c_str() + name_length,
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_lengths.push_back(name_length);
-        string_map.insert(std::make_pair(parsed_way.name, name_id));
-    }
-    else
-    {
-        name_id = string_map_iterator->second;
-    }
+    const auto name_id = external_memory.name_interner.Intern(parsed_way.name);
 
     const bool split_edge = (parsed_way.forward_speed > 0) &&
                             (TRAVEL_MODE_INACCESSIBLE != parsed_way.forward_travel_mode) &&
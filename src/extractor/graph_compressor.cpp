@@ -8,6 +8,11 @@
 
 #include "util/simple_logger.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
 namespace osrm
 {
 namespace extractor
@@ -22,29 +27,35 @@ void GraphCompressor::Compress(const std::unordered_set<NodeID> &barrier_nodes,
     const unsigned original_number_of_nodes = graph.GetNumberOfNodes();
     const unsigned original_number_of_edges = graph.GetNumberOfEdges();
 
+    // Whether a node can be compressed at all only depends on its own edges and the edges
+    // pointing to it. Compressing a neighbour redirects such an edge but keeps its data, which
+    // was compatible with the removed one, so these checks give the same answer on the
+    // unmodified graph and can run for all nodes in parallel. Only the remaining checks that
+    // depend on the order of compression and the graph updates below are serial.
+    std::vector<char> is_candidate(original_number_of_nodes, false);
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, original_number_of_nodes),
+                      [&](const tbb::blocked_range<NodeID> &range)
+                      {
+                          for (auto node_v = range.begin(); node_v != range.end(); ++node_v)
+                          {
+                              is_candidate[node_v] = IsCompressionCandidate(
+                                  node_v, barrier_nodes, traffic_lights, restriction_map, graph);
+                          }
+                      });
+
     util::Percent progress(original_number_of_nodes);
 
     for (const NodeID node_v : util::irange(0u, original_number_of_nodes))
     {
         progress.printStatus(node_v);
 
-        // only contract degree 2 vertices
-        if (2 != graph.GetOutDegree(node_v))
+        if (!is_candidate[node_v])
         {
             continue;
         }
 
-        // don't contract barrier node
-        if (barrier_nodes.end() != barrier_nodes.find(node_v))
-        {
-            continue;
-        }
-
-        // check if v is a via node for a turn restriction, i.e. a 'directed' barrier node
-        if (restriction_map.IsViaNode(node_v))
-        {
-            continue;
-        }
+        // degree, barriers, via nodes and traffic lights do not change during compression
+        BOOST_ASSERT(2 == graph.GetOutDegree(node_v));
 
         //    reverse_e2   forward_e2
         // u <---------- v -----------> w
@@ -108,16 +119,6 @@ void GraphCompressor::Compress(const std::unordered_set<NodeID> &barrier_nodes,
             BOOST_ASSERT(graph.GetEdgeData(forward_e2).name_id ==
                          graph.GetEdgeData(reverse_e2).name_id);
 
-            // Do not compress edge if it crosses a traffic signal.
-            // This can't be done in IsCompatibleTo, becase we only store the
-            // traffic signals in the `traffic_lights` list, which EdgeData
-            // doesn't have access to.
-            const bool has_node_penalty = traffic_lights.find(node_v) != traffic_lights.end();
-            if (has_node_penalty)
-            {
-                continue;
-            }
-
             // Get distances before graph is modified
             const int forward_weight1 = graph.GetEdgeData(forward_e1).distance;
             const int forward_weight2 = graph.GetEdgeData(forward_e2).distance;
@@ -174,6 +175,61 @@ void GraphCompressor::Compress(const std::unordered_set<NodeID> &barrier_nodes,
     }
 }
 
+bool GraphCompressor::IsCompressionCandidate(const NodeID node_v,
+                                             const std::unordered_set<NodeID> &barrier_nodes,
+                                             const std::unordered_set<NodeID> &traffic_lights,
+                                             const RestrictionMap &restriction_map,
+                                             const util::NodeBasedDynamicGraph &graph) const
+{
+    // only contract degree 2 vertices
+    if (2 != graph.GetOutDegree(node_v))
+    {
+        return false;
+    }
+
+    // don't contract barrier node
+    if (barrier_nodes.end() != barrier_nodes.find(node_v))
+    {
+        return false;
+    }
+
+    // check if v is a via node for a turn restriction, i.e. a 'directed' barrier node
+    if (restriction_map.IsViaNode(node_v))
+    {
+        return false;
+    }
+
+    // Do not compress edge if it crosses a traffic signal.
+    // This can't be done in IsCompatibleTo, becase we only store the
+    // traffic signals in the `traffic_lights` list, which EdgeData
+    // doesn't have access to.
+    if (traffic_lights.end() != traffic_lights.find(node_v))
+    {
+        return false;
+    }
+
+    const bool reverse_edge_order = graph.GetEdgeData(graph.BeginEdges(node_v)).reversed;
+    const EdgeID forward_e2 = graph.BeginEdges(node_v) + reverse_edge_order;
+    const EdgeID reverse_e2 = graph.BeginEdges(node_v) + 1 - reverse_edge_order;
+    const NodeID node_w = graph.GetTarget(forward_e2);
+    const NodeID node_u = graph.GetTarget(reverse_e2);
+
+    const EdgeID forward_e1 = graph.FindEdge(node_u, node_v);
+    const EdgeID reverse_e1 = graph.FindEdge(node_w, node_v);
+    BOOST_ASSERT(SPECIAL_EDGEID != forward_e1);
+    BOOST_ASSERT(SPECIAL_EDGEID != reverse_e1);
+
+    const EdgeData &fwd_edge_data1 = graph.GetEdgeData(forward_e1);
+    const EdgeData &rev_edge_data1 = graph.GetEdgeData(reverse_e1);
+    const EdgeData &fwd_edge_data2 = graph.GetEdgeData(forward_e2);
+    const EdgeData &rev_edge_data2 = graph.GetEdgeData(reverse_e2);
+
+    return fwd_edge_data1.name_id == rev_edge_data1.name_id &&
+           fwd_edge_data2.name_id == rev_edge_data2.name_id &&
+           fwd_edge_data1.IsCompatibleTo(fwd_edge_data2) &&
+           rev_edge_data1.IsCompatibleTo(rev_edge_data2);
+}
+
 void GraphCompressor::PrintStatistics(unsigned original_number_of_nodes,
                                       unsigned original_number_of_edges,
                                       const util::NodeBasedDynamicGraph &graph) const
@@ -4,6 +4,7 @@
 
 #include "util/simple_logger.hpp"
 
+#include <atomic>
 #include <limits>
 #include <utility>
 
@@ -321,7 +322,7 @@ Intersection TurnHandler::handleThreeWayTurn(const EdgeID via_edge, Intersection
 
 Intersection TurnHandler::handleComplexTurn(const EdgeID via_edge, Intersection intersection) const
 {
-    static int fallback_count = 0;
+    static std::atomic<int> fallback_count{0};
     const std::size_t obvious_index = findObviousTurn(via_edge, intersection);
     const auto fork_range = findFork(intersection);
     std::size_t straightmost_turn = 0;
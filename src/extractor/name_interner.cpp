@@ -0,0 +1,87 @@
+#include "extractor/name_interner.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+namespace osrm
+{
+namespace extractor
+{
+
+constexpr const unsigned NameInterner::MAX_NAME_LENGTH;
+constexpr const unsigned NameInterner::NUMBER_OF_SHARDS;
+constexpr const std::size_t NameInterner::ARENA_BLOCK_SIZE;
+
+NameInterner::NameInterner()
+{
+    const auto empty_name_id = Intern("");
+    BOOST_ASSERT(empty_name_id == 0);
+    static_cast<void>(empty_name_id);
+}
+
+boost::string_ref NameInterner::Shard::Store(const std::string &name)
+{
+    if (name.size() > ARENA_BLOCK_SIZE)
+    {
+        // oversized names get a block of their own, the following names start a new block
+        arena.emplace_back(new char[name.size()]);
+        arena_block_used = ARENA_BLOCK_SIZE;
+        std::memcpy(arena.back().get(), name.data(), name.size());
+        return boost::string_ref(arena.back().get(), name.size());
+    }
+
+    if (arena.empty() || arena_block_used + name.size() > ARENA_BLOCK_SIZE)
+    {
+        arena.emplace_back(new char[ARENA_BLOCK_SIZE]);
+        arena_block_used = 0;
+    }
+    char *destination = arena.back().get() + arena_block_used;
+    std::memcpy(destination, name.data(), name.size());
+    arena_block_used += name.size();
+    return boost::string_ref(destination, name.size());
+}
+
+unsigned NameInterner::Intern(const std::string &name)
+{
+    auto &shard = shards[std::hash<std::string>()(name) % NUMBER_OF_SHARDS];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto iter = shard.ids.find(boost::string_ref(name));
+    if (iter != shard.ids.end())
+    {
+        return iter->second;
+    }
+
+    const auto stored_name = shard.Store(name);
+    const auto length = std::min<unsigned>(MAX_NAME_LENGTH, stored_name.size());
+    const auto name_id =
+        static_cast<unsigned>(names.push_back({stored_name.data(), length}) - names.begin());
+    shard.ids.emplace(stored_name, name_id);
+    return name_id;
+}
+
+std::size_t NameInterner::GetNumberOfNames() const { return names.size(); }
+
+std::vector<unsigned> NameInterner::GetNameLengths() const
+{
+    std::vector<unsigned> lengths;
+    lengths.reserve(names.size());
+    for (const auto &name : names)
+    {
+        lengths.push_back(name.length);
+    }
+    return lengths;
+}
+
+void NameInterner::WriteNameData(std::ostream &out) const
+{
+    for (const auto &name : names)
+    {
+        out.write(name.data, name.length);
+    }
+}
+}
+}
@@ -19,6 +19,9 @@
 #include <osmium/osm.hpp>
 
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -101,7 +104,8 @@ void ScriptingEnvironment::InitContext(ScriptingEnvironment::Context &context)
              .property("u_turn_penalty", &ProfileProperties::GetUturnPenalty,
                        &ProfileProperties::SetUturnPenalty)
              .def_readwrite("use_turn_restrictions", &ProfileProperties::use_turn_restrictions)
-             .def_readwrite("allow_u_turn_at_via", &ProfileProperties::allow_u_turn_at_via),
+             .def_readwrite("allow_u_turn_at_via", &ProfileProperties::allow_u_turn_at_via)
+             .def_readwrite("use_turn_penalty_table", &ProfileProperties::use_turn_penalty_table),
 
          luabind::class_<std::vector<std::string>>("vector")
              .def("Add", static_cast<void (std::vector<std::string>::*)(const std::string &)>(
@@ -164,6 +168,25 @@ void ScriptingEnvironment::InitContext(ScriptingEnvironment::Context &context)
         error_stream << error_msg;
         throw util::exception("ERROR occurred in profile script:\n" + error_stream.str());
     }
+
+    context.node_tag_filter = ReadTagFilter(context.state, "get_node_tag_keys");
+    context.way_tag_filter = ReadTagFilter(context.state, "get_way_tag_keys");
+}
+
+/**
+ * Reads the tag keys a profile declares for its node or way function. Profiles
+ * that do not define the function get an inactive filter.
+ */
+TagFilter ScriptingEnvironment::ReadTagFilter(lua_State *state, const char *function_name) const
+{
+    if (!util::luaFunctionExists(state, function_name))
+    {
+        return TagFilter{};
+    }
+
+    std::vector<std::string> keys;
+    luabind::call_function<void>(state, function_name, boost::ref(keys));
+    return TagFilter{std::move(keys)};
 }
 
 ScriptingEnvironment::Context &ScriptingEnvironment::GetContex()
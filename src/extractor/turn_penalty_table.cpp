@@ -0,0 +1,43 @@
+#include "extractor/turn_penalty_table.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace osrm
+{
+namespace extractor
+{
+
+constexpr const unsigned TurnPenaltyTable::RESOLUTION;
+
+TurnPenaltyTable::TurnPenaltyTable(const std::function<int(double)> &turn_penalty)
+{
+    const unsigned number_of_samples = 360 * RESOLUTION + 1;
+    penalties.reserve(number_of_samples);
+    for (unsigned sample = 0; sample < number_of_samples; ++sample)
+    {
+        penalties.push_back(turn_penalty(static_cast<double>(sample) / RESOLUTION));
+    }
+}
+
+int TurnPenaltyTable::GetPenalty(const double angle) const
+{
+    BOOST_ASSERT(penalties.size() > 1);
+
+    const double position = std::min(std::max(angle, 0.), 360.) * RESOLUTION;
+    // angles on a sample only miss it by the rounding error of the multiplication
+    const double nearest = std::round(position);
+    if (std::abs(position - nearest) < 1e-6)
+    {
+        return penalties[static_cast<std::size_t>(nearest)];
+    }
+
+    const auto lower = std::min(static_cast<std::size_t>(position), penalties.size() - 2);
+    const double factor = position - lower;
+
+    return static_cast<int>(penalties[lower] + factor * (penalties[lower + 1] - penalties[lower]));
+}
+}
+}
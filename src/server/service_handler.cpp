@@ -15,7 +15,7 @@ namespace osrm
 {
 namespace server
 {
-ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(config)
+ServiceHandler::Dataset::Dataset(osrm::EngineConfig &config) : routing_machine(config)
 {
     service_map["route"] = util::make_unique<service::RouteService>(routing_machine);
     service_map["table"] = util::make_unique<service::TableService>(routing_machine);
@@ -25,9 +25,37 @@ ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(con
     service_map["tile"] = util::make_unique<service::TileService>(routing_machine);
 }
 
+ServiceHandler::ServiceHandler(osrm::EngineConfig &config)
+{
+    datasets[""] = util::make_unique<Dataset>(config);
+}
+
+ServiceHandler::ServiceHandler(std::unordered_map<std::string, osrm::EngineConfig> &configs)
+{
+    for (auto &name_and_config : configs)
+    {
+        datasets[name_and_config.first] = util::make_unique<Dataset>(name_and_config.second);
+    }
+}
+
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
                                         service::BaseService::ResultT &result)
 {
+    auto dataset_iter = datasets.find(parsed_url.profile);
+    if (dataset_iter == datasets.end())
+    {
+        dataset_iter = datasets.find("");
+    }
+    if (dataset_iter == datasets.end())
+    {
+        result = util::json::Object();
+        auto &json_result = result.get<util::json::Object>();
+        json_result.values["code"] = "InvalidProfile";
+        json_result.values["message"] = "Profile " + parsed_url.profile + " not found!";
+        return engine::Status::Error;
+    }
+    auto &service_map = dataset_iter->second->service_map;
+
     const auto &service_iter = service_map.find(parsed_url.service);
     if (service_iter == service_map.end())
     {
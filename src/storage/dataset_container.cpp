@@ -0,0 +1,67 @@
+#include "storage/dataset_container.hpp"
+
+#include "util/crc32_processor.hpp"
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+namespace osrm
+{
+namespace storage
+{
+
+constexpr const std::uint64_t DatasetContainer::MAGIC_NUMBER;
+constexpr const std::uint32_t DatasetContainer::VERSION;
+constexpr const std::uint64_t DatasetContainer::PAGE_SIZE;
+constexpr const std::uint64_t DatasetContainer::DATA_OFFSET;
+
+DatasetContainer::DatasetContainer(const boost::filesystem::path &path)
+{
+    const auto file_size = boost::filesystem::file_size(path);
+    if (file_size < DATA_OFFSET)
+    {
+        throw util::exception(path.string() + " is not a dataset container");
+    }
+
+    file = boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_only);
+    region = boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+    header = static_cast<const DatasetContainerHeader *>(region.get_address());
+    data = static_cast<char *>(region.get_address()) + DATA_OFFSET;
+
+    if (header->magic_number != MAGIC_NUMBER)
+    {
+        throw util::exception(path.string() + " is not a dataset container");
+    }
+    if (header->version != VERSION)
+    {
+        throw util::exception(path.string() + " has container version " +
+                              std::to_string(header->version) + ", expected " +
+                              std::to_string(VERSION) + ". Please rewrite it.");
+    }
+    if (!header->fingerprint.TestGraphUtil(util::FingerPrint::GetValid()))
+    {
+        util::SimpleLogger().Write(logWARNING) << path.string()
+                                               << " was written by a different build";
+    }
+    if (file_size < DATA_OFFSET + header->layout.GetSizeOfLayout())
+    {
+        throw util::exception(path.string() + " is truncated");
+    }
+}
+
+bool DatasetContainer::IsBlockValid(const SharedDataLayout::BlockID bid) const
+{
+    const auto *block = GetLayout().GetBlockPtr<char>(data, bid);
+    return header->block_checksums[bid] ==
+           ComputeChecksum(block, GetLayout().GetBlockSize(bid));
+}
+
+std::uint32_t DatasetContainer::ComputeChecksum(const char *block, const std::uint64_t size)
+{
+    util::BlockCRC32 crc32;
+    crc32.process(block, size);
+    return crc32.checksum();
+}
+}
+}
@@ -11,11 +11,15 @@
 #include "extractor/travel_mode.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "storage/storage.hpp"
+#include "storage/dataset_container.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_barriers.hpp"
 #include "storage/shared_memory.hpp"
 #include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
 #include "util/exception.hpp"
+#include "util/make_unique.hpp"
+#include "util/process_memory.hpp"
 #include "util/simple_logger.hpp"
 #include "util/typedefs.hpp"
 #include "util/coordinate.hpp"
@@ -25,13 +29,23 @@
 #endif
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/iostreams/seek.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+#include <algorithm>
 #include <cstdint>
 
 #include <fstream>
+#include <memory>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -43,10 +57,14 @@ using RTreeNode =
     util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>::TreeNode;
 using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
 
+// bytes read at once for files that are unpacked record by record
+constexpr const std::size_t RECORD_BLOCK_SIZE = 16 * 1024 * 1024;
+
 // delete a shared memory region. report warning if it could not be deleted
-void deleteRegion(const SharedDataType region)
+void deleteRegion(const SharedDataType region, const std::string &dataset_name)
 {
-    if (SharedMemory::RegionExists(region) && !SharedMemory::Remove(region))
+    if (SharedMemory::RegionExists(region, dataset_name) &&
+        !SharedMemory::Remove(region, dataset_name))
     {
         const std::string name = [&]
         {
@@ -73,14 +91,61 @@ void deleteRegion(const SharedDataType region)
     }
 }
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+// Reads the names of the datasources, one per line, into a flat list of characters
+void readDatasourceNames(const boost::filesystem::path &datasource_names_path,
+                         std::vector<char> &name_data,
+                         std::vector<std::size_t> &name_offsets,
+                         std::vector<std::size_t> &name_lengths)
+{
+    boost::filesystem::ifstream datasource_names_input_stream(datasource_names_path,
+                                                              std::ios::binary);
+    if (!datasource_names_input_stream)
+    {
+        throw util::exception("Could not open " + datasource_names_path.string() +
+                              " for reading.");
+    }
+    std::string name;
+    while (std::getline(datasource_names_input_stream, name))
+    {
+        name_offsets.push_back(name_data.size());
+        std::copy(name.c_str(), name.c_str() + name.size(), std::back_inserter(name_data));
+        name_lengths.push_back(name.size());
+    }
+}
+
+// Reads number_of_records records in large blocks and hands each record to unpack
+template <typename RecordT, typename UnpackT>
+void readRecordsInBlocks(std::istream &stream, const std::size_t number_of_records, UnpackT unpack)
+{
+    const std::size_t records_per_block =
+        std::max<std::size_t>(1, RECORD_BLOCK_SIZE / sizeof(RecordT));
+    std::vector<RecordT> block(std::min(number_of_records, records_per_block));
+    for (std::size_t offset = 0; offset < number_of_records; offset += block.size())
+    {
+        const std::size_t records_in_block = std::min(block.size(), number_of_records - offset);
+        stream.read(reinterpret_cast<char *>(block.data()), records_in_block * sizeof(RecordT));
+        for (const auto i : util::irange<std::size_t>(0, records_in_block))
+        {
+            unpack(offset + i, block[i]);
+        }
+    }
+}
+
+Storage::Storage(StorageConfig config_,
+                 const bool use_huge_pages,
+                 std::string dataset_name_,
+                 const bool compress_geometries)
+    : config(std::move(config_)), use_huge_pages(use_huge_pages),
+      dataset_name(std::move(dataset_name_)), compress_geometries(compress_geometries)
+{
+}
 
 int Storage::Run()
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
     util::LogPolicy::GetInstance().Unmute();
-    SharedBarriers barrier;
+    SharedBarriers barrier(dataset_name);
 
 #ifdef __linux__
     // try to disable swapping on Linux
@@ -103,7 +168,7 @@ int Storage::Run()
     }
 
     // determine segment to use
-    bool segment2_in_use = SharedMemory::RegionExists(LAYOUT_2);
+    bool segment2_in_use = SharedMemory::RegionExists(LAYOUT_2, dataset_name);
     const storage::SharedDataType layout_region = [&]
     {
         return segment2_in_use ? LAYOUT_1 : LAYOUT_2;
@@ -122,12 +187,194 @@ int Storage::Run()
     }();
 
     // Allocate a memory layout in shared memory, deallocate previous
-    auto *layout_memory = makeSharedMemory(layout_region, sizeof(SharedDataLayout));
+    auto *layout_memory = makeSharedMemory(layout_region, sizeof(SharedDataLayout), false, true,
+                                           false, dataset_name);
     auto shared_layout_ptr = new (layout_memory->Ptr()) SharedDataLayout();
+
+    std::unique_ptr<DatasetContainer> container;
+    if (config.dataset_path.empty())
+    {
+        PopulateLayout(*shared_layout_ptr);
+    }
+    else
+    {
+        util::SimpleLogger().Write() << "load dataset container: " << config.dataset_path;
+        container = util::make_unique<DatasetContainer>(config.dataset_path);
+        *shared_layout_ptr = container->GetLayout();
+    }
+
+    // allocate shared memory block
+    const uint64_t huge_page_size = use_huge_pages ? SharedMemory::GetHugePageSize() : 0;
+    if (use_huge_pages && 0 == huge_page_size)
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "huge pages are not supported, using normal pages";
+    }
+    if (0 != huge_page_size)
+    {
+        // Start large blocks on a page boundary so they use as few pages as possible. Beyond
+        // 2 MiB, e.g. with 1 GiB pages, the padding costs more than the page it might save.
+        shared_layout_ptr->block_alignment = std::min<uint64_t>(huge_page_size, 2 * 1024 * 1024);
+    }
+    util::SimpleLogger().Write() << "allocating shared memory of "
+                                 << shared_layout_ptr->GetSizeOfLayout() << " bytes";
+    auto *shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout(), false,
+                                           true, 0 != huge_page_size, dataset_name);
+    if (0 != huge_page_size && !shared_memory->UsesHugePages())
+    {
+        // the padding is of no use on normal pages
+        delete shared_memory;
+        shared_layout_ptr->block_alignment = 1;
+        util::SimpleLogger().Write() << "allocating shared memory of "
+                                     << shared_layout_ptr->GetSizeOfLayout() << " bytes";
+        shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout(), false,
+                                         true, false, dataset_name);
+    }
+    char *shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+
+    if (container)
+    {
+        CopyContainer(*container, *shared_layout_ptr, shared_memory_ptr);
+    }
+    else
+    {
+        PopulateData(*shared_layout_ptr, shared_memory_ptr);
+    }
+
+    // open the region that points readers to the current data
+    SharedMemory *data_type_memory =
+        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false, false,
+                         dataset_name);
+    SharedDataTimestamp *data_timestamp_ptr =
+        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
+
+    // Publish the new regions. Running queries keep the previous regions pinned, and
+    // removing them only unlinks them: they stay mapped until the last reader has
+    // switched to the new data and detached.
+    data_timestamp_ptr->layout = layout_region;
+    data_timestamp_ptr->data = data_region;
+    data_timestamp_ptr->timestamp += 1;
+    deleteRegion(previous_data_region, dataset_name);
+    deleteRegion(previous_layout_region, dataset_name);
+    util::SimpleLogger().Write() << "all data loaded";
+
+    return EXIT_SUCCESS;
+}
+
+int Storage::WriteContainer(const boost::filesystem::path &container_path)
+{
+    BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
+
+    DatasetContainerHeader header;
+    header.magic_number = DatasetContainer::MAGIC_NUMBER;
+    header.version = DatasetContainer::VERSION;
+    header.fingerprint = util::FingerPrint::GetValid();
+    header.layout = SharedDataLayout();
+    // blocks on pages of their own can be mapped and paged in independently
+    header.layout.block_alignment = DatasetContainer::PAGE_SIZE;
+    PopulateLayout(header.layout);
+
+    const auto container_size = DatasetContainer::DATA_OFFSET + header.layout.GetSizeOfLayout();
+    util::SimpleLogger().Write() << "writing dataset container of " << container_size
+                                 << " bytes to " << container_path;
+    {
+        boost::filesystem::ofstream container_stream(container_path, std::ios::binary);
+        if (!container_stream)
+        {
+            throw util::exception("Could not open " + container_path.string() + " for writing.");
+        }
+    }
+    boost::filesystem::resize_file(container_path, container_size);
+
+    boost::interprocess::file_mapping file(container_path.string().c_str(),
+                                           boost::interprocess::read_write);
+    boost::interprocess::mapped_region region(file, boost::interprocess::read_write);
+    char *data_ptr = static_cast<char *>(region.get_address()) + DatasetContainer::DATA_OFFSET;
+
+    PopulateData(header.layout, data_ptr);
+
+    tbb::parallel_for(0, static_cast<int>(SharedDataLayout::NUM_BLOCKS), [&](const int block)
+                      {
+                          const auto bid = static_cast<SharedDataLayout::BlockID>(block);
+                          header.block_checksums[bid] = DatasetContainer::ComputeChecksum(
+                              data_ptr + header.layout.GetBlockOffset(bid),
+                              header.layout.GetBlockSize(bid));
+                      });
+
+    // write the header last, so an interrupted write leaves no valid container behind
+    std::copy(reinterpret_cast<const char *>(&header),
+              reinterpret_cast<const char *>(&header) + sizeof(header),
+              static_cast<char *>(region.get_address()));
+    if (!region.flush())
+    {
+        throw util::exception("Could not write " + container_path.string());
+    }
+    util::SimpleLogger().Write() << "dataset container written";
+
+    return EXIT_SUCCESS;
+}
+
+int Storage::ReportResidentSize()
+{
+    std::unique_ptr<DatasetContainer> container;
+    std::unique_ptr<SharedMemory> layout_memory;
+    std::unique_ptr<SharedMemory> data_memory;
+    const SharedDataLayout *layout = nullptr;
+    const char *data_ptr = nullptr;
+    if (!config.dataset_path.empty())
+    {
+        // the pages of a container are shared through the page cache, so this is what all
+        // processes mapping it hold in memory together
+        container = util::make_unique<DatasetContainer>(config.dataset_path);
+        layout = &container->GetLayout();
+        data_ptr = container->GetDataPtr();
+    }
+    else
+    {
+        if (!SharedMemory::RegionExists(CURRENT_REGIONS, dataset_name))
+        {
+            util::SimpleLogger().Write(logWARNING) << "No dataset found in shared memory";
+            return EXIT_FAILURE;
+        }
+        // attach read-only, writeable regions would be removed again on exit
+        const std::unique_ptr<SharedMemory> timestamp_memory(
+            makeSharedMemory(CURRENT_REGIONS, 0, false, false, false, dataset_name));
+        const auto *data_timestamp_ptr =
+            static_cast<const SharedDataTimestamp *>(timestamp_memory->Ptr());
+        layout_memory.reset(
+            makeSharedMemory(data_timestamp_ptr->layout, 0, false, false, false, dataset_name));
+        data_memory.reset(
+            makeSharedMemory(data_timestamp_ptr->data, 0, false, false, false, dataset_name));
+        layout = static_cast<const SharedDataLayout *>(layout_memory->Ptr());
+        data_ptr = static_cast<const char *>(data_memory->Ptr());
+    }
+
+    std::size_t total_size = 0;
+    std::size_t total_resident_size = 0;
+    for (const auto block : util::irange<int>(0, SharedDataLayout::NUM_BLOCKS))
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(block);
+        const auto size = layout->GetBlockSize(bid);
+        const auto resident_size =
+            util::getResidentSize(data_ptr + layout->GetBlockOffset(bid), size);
+        util::SimpleLogger().Write() << SharedDataLayout::GetBlockName(bid) << ": "
+                                     << resident_size << " of " << size << " bytes resident";
+        total_size += size;
+        total_resident_size += resident_size;
+    }
+    util::SimpleLogger().Write() << "total: " << total_resident_size << " of " << total_size
+                                 << " bytes resident";
+
+    return EXIT_SUCCESS;
+}
+
+// Computes the size of every block from the file headers
+void Storage::PopulateLayout(SharedDataLayout &layout)
+{
     auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
 
-    shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
-                                          absolute_file_index_path.string().length() + 1);
+    layout.SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
+                              absolute_file_index_path.string().length() + 1);
 
     // collect number of elements to store in shared memory object
     util::SimpleLogger().Write() << "load names from: " << config.names_data_path;
@@ -139,15 +386,15 @@ int Storage::Run()
     }
     unsigned name_blocks = 0;
     name_stream.read((char *)&name_blocks, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::NAME_OFFSETS, name_blocks);
-    shared_layout_ptr->SetBlockSize<typename util::RangeTable<16, true>::BlockT>(
+    layout.SetBlockSize<unsigned>(SharedDataLayout::NAME_OFFSETS, name_blocks);
+    layout.SetBlockSize<typename util::RangeTable<16, true>::BlockT>(
         SharedDataLayout::NAME_BLOCKS, name_blocks);
     util::SimpleLogger().Write() << "name offsets size: " << name_blocks;
     BOOST_ASSERT_MSG(0 != name_blocks, "name file broken");
 
     unsigned number_of_chars = 0;
     name_stream.read((char *)&number_of_chars, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::NAME_CHAR_LIST, number_of_chars);
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_CHAR_LIST, number_of_chars);
 
     // Loading information for original edges
     boost::filesystem::ifstream edges_input_stream(config.edges_data_path, std::ios::binary);
@@ -159,13 +406,11 @@ int Storage::Run()
     edges_input_stream.read((char *)&number_of_original_edges, sizeof(unsigned));
 
     // note: settings this all to the same size is correct, we extract them from the same struct
-    shared_layout_ptr->SetBlockSize<NodeID>(SharedDataLayout::VIA_NODE_LIST,
-                                            number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::NAME_ID_LIST,
-                                              number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<extractor::TravelMode>(SharedDataLayout::TRAVEL_MODE,
-                                                           number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<extractor::guidance::TurnInstruction>(
+    layout.SetBlockSize<NodeID>(SharedDataLayout::VIA_NODE_LIST, number_of_original_edges);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::NAME_ID_LIST, number_of_original_edges);
+    layout.SetBlockSize<extractor::TravelMode>(SharedDataLayout::TRAVEL_MODE,
+                                               number_of_original_edges);
+    layout.SetBlockSize<extractor::guidance::TurnInstruction>(
         SharedDataLayout::TURN_INSTRUCTION, number_of_original_edges);
 
     boost::filesystem::ifstream hsgr_input_stream(config.hsgr_data_path, std::ios::binary);
@@ -190,37 +435,37 @@ int Storage::Run()
     // load checksum
     unsigned checksum = 0;
     hsgr_input_stream.read((char *)&checksum, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::HSGR_CHECKSUM, 1);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::HSGR_CHECKSUM, 1);
     // load graph node size
     unsigned number_of_graph_nodes = 0;
     hsgr_input_stream.read((char *)&number_of_graph_nodes, sizeof(unsigned));
 
     BOOST_ASSERT_MSG((0 != number_of_graph_nodes), "number of nodes is zero");
-    shared_layout_ptr->SetBlockSize<QueryGraph::NodeArrayEntry>(SharedDataLayout::GRAPH_NODE_LIST,
-                                                                number_of_graph_nodes);
+    layout.SetBlockSize<QueryGraph::NodeArrayEntry>(SharedDataLayout::GRAPH_NODE_LIST,
+                                                    number_of_graph_nodes);
 
     // load graph edge size
     unsigned number_of_graph_edges = 0;
     hsgr_input_stream.read((char *)&number_of_graph_edges, sizeof(unsigned));
     // BOOST_ASSERT_MSG(0 != number_of_graph_edges, "number of graph edges is zero");
-    shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
-                                                                number_of_graph_edges);
+    layout.SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
+                                                    number_of_graph_edges);
 
     // load rsearch tree size
     boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
 
     uint32_t tree_size = 0;
     tree_node_file.read((char *)&tree_size, sizeof(uint32_t));
-    shared_layout_ptr->SetBlockSize<RTreeNode>(SharedDataLayout::R_SEARCH_TREE, tree_size);
+    layout.SetBlockSize<RTreeNode>(SharedDataLayout::R_SEARCH_TREE, tree_size);
 
     // load profile properties
-    shared_layout_ptr->SetBlockSize<extractor::ProfileProperties>(SharedDataLayout::PROPERTIES, 1);
+    layout.SetBlockSize<extractor::ProfileProperties>(SharedDataLayout::PROPERTIES, 1);
 
     // load timestamp size
     boost::filesystem::ifstream timestamp_stream(config.timestamp_path);
     std::string m_timestamp;
     getline(timestamp_stream, m_timestamp);
-    shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::TIMESTAMP, m_timestamp.length());
+    layout.SetBlockSize<char>(SharedDataLayout::TIMESTAMP, m_timestamp.length());
 
     // load core marker size
     boost::filesystem::ifstream core_marker_file(config.core_data_path, std::ios::binary);
@@ -231,8 +476,7 @@ int Storage::Run()
 
     uint32_t number_of_core_markers = 0;
     core_marker_file.read((char *)&number_of_core_markers, sizeof(uint32_t));
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::CORE_MARKER,
-                                              number_of_core_markers);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::CORE_MARKER, number_of_core_markers);
 
     // load coordinate size
     boost::filesystem::ifstream nodes_input_stream(config.nodes_data_path, std::ios::binary);
@@ -242,8 +486,7 @@ int Storage::Run()
     }
     unsigned coordinate_list_size = 0;
     nodes_input_stream.read((char *)&coordinate_list_size, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<util::Coordinate>(SharedDataLayout::COORDINATE_LIST,
-                                                      coordinate_list_size);
+    layout.SetBlockSize<util::Coordinate>(SharedDataLayout::COORDINATE_LIST, coordinate_list_size);
 
     // load geometries sizes
     boost::filesystem::ifstream geometry_input_stream(config.geometries_path, std::ios::binary);
@@ -255,12 +498,11 @@ int Storage::Run()
     unsigned number_of_compressed_geometries = 0;
 
     geometry_input_stream.read((char *)&number_of_geometries_indices, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::GEOMETRIES_INDEX,
-                                              number_of_geometries_indices);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::GEOMETRIES_INDEX, number_of_geometries_indices);
     boost::iostreams::seek(geometry_input_stream, number_of_geometries_indices * sizeof(unsigned),
                            BOOST_IOS::cur);
     geometry_input_stream.read((char *)&number_of_compressed_geometries, sizeof(unsigned));
-    shared_layout_ptr->SetBlockSize<extractor::CompressedEdgeContainer::CompressedEdge>(
+    layout.SetBlockSize<extractor::CompressedEdgeContainer::CompressedEdge>(
         SharedDataLayout::GEOMETRIES_LIST, number_of_compressed_geometries);
 
     // load datasource sizes.  This file is optional, and it's non-fatal if it doesn't
@@ -277,298 +519,417 @@ int Storage::Run()
         geometry_datasource_input_stream.read(
             reinterpret_cast<char *>(&number_of_compressed_datasources), sizeof(std::size_t));
     }
-    shared_layout_ptr->SetBlockSize<uint8_t>(SharedDataLayout::DATASOURCES_LIST,
-                                             number_of_compressed_datasources);
+    layout.SetBlockSize<uint8_t>(SharedDataLayout::DATASOURCES_LIST,
+                                 number_of_compressed_datasources);
 
     // Load datasource name sizes.  This file is optional, and it's non-fatal if it doesn't
     // exist
-    boost::filesystem::ifstream datasource_names_input_stream(config.datasource_names_path,
-                                                              std::ios::binary);
-    if (!datasource_names_input_stream)
-    {
-        throw util::exception("Could not open " + config.datasource_names_path.string() + " for reading.");
-    }
     std::vector<char> m_datasource_name_data;
     std::vector<std::size_t> m_datasource_name_offsets;
     std::vector<std::size_t> m_datasource_name_lengths;
-    if (datasource_names_input_stream)
+    readDatasourceNames(config.datasource_names_path, m_datasource_name_data,
+                        m_datasource_name_offsets, m_datasource_name_lengths);
+    layout.SetBlockSize<char>(SharedDataLayout::DATASOURCE_NAME_DATA,
+                              m_datasource_name_data.size());
+    layout.SetBlockSize<std::size_t>(SharedDataLayout::DATASOURCE_NAME_OFFSETS,
+                                     m_datasource_name_offsets.size());
+    layout.SetBlockSize<std::size_t>(SharedDataLayout::DATASOURCE_NAME_LENGTHS,
+                                     m_datasource_name_lengths.size());
+
+    if (compress_geometries)
     {
-        std::string name;
-        while (std::getline(datasource_names_input_stream, name))
-        {
-            m_datasource_name_offsets.push_back(m_datasource_name_data.size());
-            std::copy(name.c_str(), name.c_str() + name.size(),
-                      std::back_inserter(m_datasource_name_data));
-            m_datasource_name_lengths.push_back(name.size());
-        }
+        PackGeometries(layout);
     }
-    shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::DATASOURCE_NAME_DATA,
-                                          m_datasource_name_data.size());
-    shared_layout_ptr->SetBlockSize<std::size_t>(SharedDataLayout::DATASOURCE_NAME_OFFSETS,
-                                                 m_datasource_name_offsets.size());
-    shared_layout_ptr->SetBlockSize<std::size_t>(SharedDataLayout::DATASOURCE_NAME_LENGTHS,
-                                                 m_datasource_name_lengths.size());
+}
 
-    // allocate shared memory block
-    util::SimpleLogger().Write() << "allocating shared memory of "
-                                 << shared_layout_ptr->GetSizeOfLayout() << " bytes";
-    auto *shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout());
-    char *shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+// Encodes the coordinates and the geometries, which replace the plain blocks in the layout
+void Storage::PackGeometries(SharedDataLayout &layout)
+{
+    packed_coordinates = util::PackedPairListBuilder();
+    packed_geometries = util::PackedPairListBuilder();
 
-    // read actual data into shared memory object //
+    tbb::parallel_invoke(
+        [&]
+        {
+            boost::filesystem::ifstream nodes_input_stream(config.nodes_data_path,
+                                                           std::ios::binary);
+            nodes_input_stream.seekg(sizeof(unsigned));
+            readRecordsInBlocks<extractor::QueryNode>(
+                nodes_input_stream, layout.num_entries[SharedDataLayout::COORDINATE_LIST],
+                [&](const std::size_t, const extractor::QueryNode &current_node)
+                {
+                    packed_coordinates.Add(static_cast<std::int32_t>(current_node.lon),
+                                           static_cast<std::int32_t>(current_node.lat));
+                });
+        },
+        [&]
+        {
+            boost::filesystem::ifstream geometry_input_stream(config.geometries_path,
+                                                              std::ios::binary);
+            // skip the index and the number of geometries
+            geometry_input_stream.seekg(
+                (layout.num_entries[SharedDataLayout::GEOMETRIES_INDEX] + 2) * sizeof(unsigned));
+            readRecordsInBlocks<extractor::CompressedEdgeContainer::CompressedEdge>(
+                geometry_input_stream, layout.num_entries[SharedDataLayout::GEOMETRIES_LIST],
+                [&](const std::size_t,
+                    const extractor::CompressedEdgeContainer::CompressedEdge &edge)
+                {
+                    packed_geometries.Add(static_cast<std::int32_t>(edge.node_id), edge.weight);
+                });
+        });
+
+    util::SimpleLogger().Write() << "compressed coordinates from "
+                                 << layout.GetBlockSize(SharedDataLayout::COORDINATE_LIST)
+                                 << " to " << packed_coordinates.GetBufferSize() << " bytes";
+    util::SimpleLogger().Write() << "compressed geometries from "
+                                 << layout.GetBlockSize(SharedDataLayout::GEOMETRIES_LIST)
+                                 << " to " << packed_geometries.GetBufferSize() << " bytes";
+
+    layout.SetBlockSize<util::Coordinate>(SharedDataLayout::COORDINATE_LIST, 0);
+    layout.SetBlockSize<extractor::CompressedEdgeContainer::CompressedEdge>(
+        SharedDataLayout::GEOMETRIES_LIST, 0);
+    layout.SetBlockSize<char>(SharedDataLayout::PACKED_COORDINATE_LIST,
+                              packed_coordinates.GetBufferSize());
+    layout.SetBlockSize<char>(SharedDataLayout::PACKED_GEOMETRIES_LIST,
+                              packed_geometries.GetBufferSize());
+}
 
-    // hsgr checksum
-    unsigned *checksum_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::HSGR_CHECKSUM);
-    *checksum_ptr = checksum;
+// Loads the data of every block into the memory described by the layout
+void Storage::PopulateData(const SharedDataLayout &layout, char *memory_ptr)
+{
+    // Every block has its own input stream that skips the header PopulateLayout read
+    const auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
+    const auto number_of_original_edges = layout.num_entries[SharedDataLayout::VIA_NODE_LIST];
+    const auto coordinate_list_size = layout.num_entries[SharedDataLayout::COORDINATE_LIST];
+    const auto tree_size = layout.num_entries[SharedDataLayout::R_SEARCH_TREE];
+    const auto number_of_core_markers = layout.num_entries[SharedDataLayout::CORE_MARKER];
 
-    // ram index file name
-    char *file_index_path_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::FILE_INDEX_PATH);
-    // make sure we have 0 ending
-    std::fill(file_index_path_ptr,
-              file_index_path_ptr +
-                  shared_layout_ptr->GetBlockSize(SharedDataLayout::FILE_INDEX_PATH),
-              0);
-    std::copy(absolute_file_index_path.string().begin(), absolute_file_index_path.string().end(), file_index_path_ptr);
-
-    // Loading street names
-    unsigned *name_offsets_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_OFFSETS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_OFFSETS) > 0)
-    {
-        name_stream.read((char *)name_offsets_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_OFFSETS));
-    }
+    boost::filesystem::ifstream name_stream(config.names_data_path, std::ios::binary);
+    name_stream.seekg(2 * sizeof(unsigned));
 
-    unsigned *name_blocks_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_BLOCKS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_BLOCKS) > 0)
-    {
-        name_stream.read((char *)name_blocks_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_BLOCKS));
-    }
+    boost::filesystem::ifstream edges_input_stream(config.edges_data_path, std::ios::binary);
+    edges_input_stream.seekg(sizeof(unsigned));
 
-    char *name_char_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
-    unsigned temp_length;
-    name_stream.read((char *)&temp_length, sizeof(unsigned));
+    boost::filesystem::ifstream hsgr_input_stream(config.hsgr_data_path, std::ios::binary);
+    hsgr_input_stream.seekg(sizeof(util::FingerPrint));
+    unsigned checksum = 0;
+    hsgr_input_stream.read((char *)&checksum, sizeof(unsigned));
+    // skip the number of nodes and edges
+    hsgr_input_stream.seekg(2 * sizeof(unsigned), BOOST_IOS::cur);
 
-    BOOST_ASSERT_MSG(temp_length ==
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST),
-                     "Name file corrupted!");
+    boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
+    tree_node_file.seekg(sizeof(uint32_t));
 
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST) > 0)
-    {
-        name_stream.read(name_char_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST));
-    }
+    boost::filesystem::ifstream timestamp_stream(config.timestamp_path);
+    std::string m_timestamp;
+    getline(timestamp_stream, m_timestamp);
 
-    name_stream.close();
+    boost::filesystem::ifstream core_marker_file(config.core_data_path, std::ios::binary);
+    core_marker_file.seekg(sizeof(uint32_t));
 
-    // load original edge information
-    NodeID *via_node_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
-        shared_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
+    boost::filesystem::ifstream nodes_input_stream(config.nodes_data_path, std::ios::binary);
+    nodes_input_stream.seekg(sizeof(unsigned));
 
-    unsigned *name_id_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_ID_LIST);
+    boost::filesystem::ifstream geometry_input_stream(config.geometries_path, std::ios::binary);
 
-    extractor::TravelMode *travel_mode_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::TravelMode, true>(shared_memory_ptr,
-                                                                    SharedDataLayout::TRAVEL_MODE);
+    boost::filesystem::ifstream geometry_datasource_input_stream(config.datasource_indexes_path,
+                                                                 std::ios::binary);
+    geometry_datasource_input_stream.seekg(sizeof(std::size_t));
 
-    extractor::guidance::TurnInstruction *turn_instructions_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
+    std::vector<char> m_datasource_name_data;
+    std::vector<std::size_t> m_datasource_name_offsets;
+    std::vector<std::size_t> m_datasource_name_lengths;
+    readDatasourceNames(config.datasource_names_path, m_datasource_name_data,
+                        m_datasource_name_offsets, m_datasource_name_lengths);
 
-    extractor::OriginalEdgeData current_edge_data;
-    for (unsigned i = 0; i < number_of_original_edges; ++i)
-    {
-        edges_input_stream.read((char *)&(current_edge_data), sizeof(extractor::OriginalEdgeData));
-        via_node_ptr[i] = current_edge_data.via_node;
-        name_id_ptr[i] = current_edge_data.name_id;
-        travel_mode_ptr[i] = current_edge_data.travel_mode;
-        turn_instructions_ptr[i] = current_edge_data.turn_instruction;
-    }
-    edges_input_stream.close();
-
-    // load compressed geometry
-    unsigned temporary_value;
-    unsigned *geometries_index_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_INDEX);
-    geometry_input_stream.seekg(0, geometry_input_stream.beg);
-    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
-    BOOST_ASSERT(temporary_value ==
-                 shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
-
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX) > 0)
-    {
-        geometry_input_stream.read(
-            (char *)geometries_index_ptr,
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX));
-    }
-    extractor::CompressedEdgeContainer::CompressedEdge *geometries_list_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::CompressedEdgeContainer::CompressedEdge, true>(
-            shared_memory_ptr, SharedDataLayout::GEOMETRIES_LIST);
+    // hsgr checksum
+    unsigned *checksum_ptr = layout.GetBlockPtr<unsigned, true>(
+        memory_ptr, SharedDataLayout::HSGR_CHECKSUM);
+    *checksum_ptr = checksum;
 
-    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
-    BOOST_ASSERT(temporary_value ==
-                 shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_LIST]);
+    // ram index file name
+    char *file_index_path_ptr = layout.GetBlockPtr<char, true>(
+        memory_ptr, SharedDataLayout::FILE_INDEX_PATH);
+    // make sure we have 0 ending
+    std::fill(file_index_path_ptr,
+              file_index_path_ptr + layout.GetBlockSize(SharedDataLayout::FILE_INDEX_PATH), 0);
+    std::copy(absolute_file_index_path.string().begin(), absolute_file_index_path.string().end(),
+              file_index_path_ptr);
+
+    // Every block has its own input stream, which already points to the block's data, and its
+    // own part of the shared memory region, so all blocks are loaded concurrently.
+    tbb::parallel_invoke(
+        [&]
+        {
+            // Loading street names
+            unsigned *name_offsets_ptr = layout.GetBlockPtr<unsigned, true>(
+                memory_ptr, SharedDataLayout::NAME_OFFSETS);
+            if (layout.GetBlockSize(SharedDataLayout::NAME_OFFSETS) > 0)
+            {
+                name_stream.read((char *)name_offsets_ptr,
+                                 layout.GetBlockSize(SharedDataLayout::NAME_OFFSETS));
+            }
 
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_LIST) > 0)
-    {
-        geometry_input_stream.read(
-            (char *)geometries_list_ptr,
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_LIST));
-    }
+            unsigned *name_blocks_ptr = layout.GetBlockPtr<unsigned, true>(
+                memory_ptr, SharedDataLayout::NAME_BLOCKS);
+            if (layout.GetBlockSize(SharedDataLayout::NAME_BLOCKS) > 0)
+            {
+                name_stream.read((char *)name_blocks_ptr,
+                                 layout.GetBlockSize(SharedDataLayout::NAME_BLOCKS));
+            }
 
-    // load datasource information (if it exists)
-    uint8_t *datasources_list_ptr = shared_layout_ptr->GetBlockPtr<uint8_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCES_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCES_LIST) > 0)
-    {
-        geometry_datasource_input_stream.read(
-            reinterpret_cast<char *>(datasources_list_ptr),
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCES_LIST));
-    }
+            char *name_char_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
+            unsigned temp_length;
+            name_stream.read((char *)&temp_length, sizeof(unsigned));
 
-    // load datasource name information (if it exists)
-    char *datasource_name_data_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_DATA);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_DATA) > 0)
-    {
-        std::cout << "Copying " << (m_datasource_name_data.end() - m_datasource_name_data.begin())
-                  << " chars into name data ptr\n";
-        std::copy(m_datasource_name_data.begin(), m_datasource_name_data.end(),
-                  datasource_name_data_ptr);
-    }
+            BOOST_ASSERT_MSG(temp_length == layout.GetBlockSize(SharedDataLayout::NAME_CHAR_LIST),
+                             "Name file corrupted!");
 
-    auto datasource_name_offsets_ptr = shared_layout_ptr->GetBlockPtr<std::size_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_OFFSETS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_OFFSETS) > 0)
-    {
-        std::copy(m_datasource_name_offsets.begin(), m_datasource_name_offsets.end(),
-                  datasource_name_offsets_ptr);
-    }
+            if (layout.GetBlockSize(SharedDataLayout::NAME_CHAR_LIST) > 0)
+            {
+                name_stream.read(name_char_ptr,
+                                 layout.GetBlockSize(SharedDataLayout::NAME_CHAR_LIST));
+            }
 
-    auto datasource_name_lengths_ptr = shared_layout_ptr->GetBlockPtr<std::size_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_LENGTHS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_LENGTHS) > 0)
-    {
-        std::copy(m_datasource_name_lengths.begin(), m_datasource_name_lengths.end(),
-                  datasource_name_lengths_ptr);
-    }
+            name_stream.close();
+        },
+        [&]
+        {
+            // load original edge information
+            NodeID *via_node_ptr = layout.GetBlockPtr<NodeID, true>(
+                memory_ptr, SharedDataLayout::VIA_NODE_LIST);
 
-    // Loading list of coordinates
-    util::Coordinate *coordinates_ptr = shared_layout_ptr->GetBlockPtr<util::Coordinate, true>(
-        shared_memory_ptr, SharedDataLayout::COORDINATE_LIST);
+            unsigned *name_id_ptr = layout.GetBlockPtr<unsigned, true>(
+                memory_ptr, SharedDataLayout::NAME_ID_LIST);
 
-    extractor::QueryNode current_node;
-    for (unsigned i = 0; i < coordinate_list_size; ++i)
-    {
-        nodes_input_stream.read((char *)&current_node, sizeof(extractor::QueryNode));
-        coordinates_ptr[i] = util::Coordinate(current_node.lon, current_node.lat);
-    }
-    nodes_input_stream.close();
+            extractor::TravelMode *travel_mode_ptr =
+                layout.GetBlockPtr<extractor::TravelMode, true>(
+                    memory_ptr, SharedDataLayout::TRAVEL_MODE);
 
-    // store timestamp
-    char *timestamp_ptr =
-        shared_layout_ptr->GetBlockPtr<char, true>(shared_memory_ptr, SharedDataLayout::TIMESTAMP);
-    std::copy(m_timestamp.c_str(), m_timestamp.c_str() + m_timestamp.length(), timestamp_ptr);
+            extractor::guidance::TurnInstruction *turn_instructions_ptr =
+                layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
+                    memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
 
-    // store search tree portion of rtree
-    char *rtree_ptr = shared_layout_ptr->GetBlockPtr<char, true>(shared_memory_ptr,
-                                                                 SharedDataLayout::R_SEARCH_TREE);
+            readRecordsInBlocks<extractor::OriginalEdgeData>(
+                edges_input_stream, number_of_original_edges,
+                [&](const std::size_t i, const extractor::OriginalEdgeData &current_edge_data)
+                {
+                    via_node_ptr[i] = current_edge_data.via_node;
+                    name_id_ptr[i] = current_edge_data.name_id;
+                    travel_mode_ptr[i] = current_edge_data.travel_mode;
+                    turn_instructions_ptr[i] = current_edge_data.turn_instruction;
+                });
+            edges_input_stream.close();
+        },
+        [&]
+        {
+            // load compressed geometry
+            unsigned temporary_value;
+            unsigned *geometries_index_ptr = layout.GetBlockPtr<unsigned, true>(
+                memory_ptr, SharedDataLayout::GEOMETRIES_INDEX);
+            geometry_input_stream.seekg(0, geometry_input_stream.beg);
+            geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+            BOOST_ASSERT(temporary_value == layout.num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
+
+            if (layout.GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX) > 0)
+            {
+                geometry_input_stream.read(
+                    (char *)geometries_index_ptr,
+                    layout.GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX));
+            }
+            extractor::CompressedEdgeContainer::CompressedEdge *geometries_list_ptr =
+                layout.GetBlockPtr<extractor::CompressedEdgeContainer::CompressedEdge, true>(
+                    memory_ptr, SharedDataLayout::GEOMETRIES_LIST);
+            // only one of the plain and the packed block is used, but both need canaries
+            char *packed_geometries_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::PACKED_GEOMETRIES_LIST);
+            if (compress_geometries)
+            {
+                packed_geometries.Write(packed_geometries_ptr);
+                return;
+            }
 
-    if (tree_size > 0)
-    {
-        tree_node_file.read(rtree_ptr, sizeof(RTreeNode) * tree_size);
-    }
-    tree_node_file.close();
+            geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+            BOOST_ASSERT(temporary_value == layout.num_entries[SharedDataLayout::GEOMETRIES_LIST]);
 
-    // load core markers
-    std::vector<char> unpacked_core_markers(number_of_core_markers);
-    core_marker_file.read((char *)unpacked_core_markers.data(),
-                          sizeof(char) * number_of_core_markers);
+            if (layout.GetBlockSize(SharedDataLayout::GEOMETRIES_LIST) > 0)
+            {
+                geometry_input_stream.read(
+                    (char *)geometries_list_ptr,
+                    layout.GetBlockSize(SharedDataLayout::GEOMETRIES_LIST));
+            }
+        },
+        [&]
+        {
+            // load datasource information (if it exists)
+            uint8_t *datasources_list_ptr = layout.GetBlockPtr<uint8_t, true>(
+                memory_ptr, SharedDataLayout::DATASOURCES_LIST);
+            if (layout.GetBlockSize(SharedDataLayout::DATASOURCES_LIST) > 0)
+            {
+                geometry_datasource_input_stream.read(
+                    reinterpret_cast<char *>(datasources_list_ptr),
+                    layout.GetBlockSize(SharedDataLayout::DATASOURCES_LIST));
+            }
 
-    unsigned *core_marker_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::CORE_MARKER);
+            // load datasource name information (if it exists)
+            char *datasource_name_data_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::DATASOURCE_NAME_DATA);
+            if (layout.GetBlockSize(SharedDataLayout::DATASOURCE_NAME_DATA) > 0)
+            {
+                std::cout << "Copying "
+                          << (m_datasource_name_data.end() - m_datasource_name_data.begin())
+                          << " chars into name data ptr\n";
+                std::copy(m_datasource_name_data.begin(), m_datasource_name_data.end(),
+                          datasource_name_data_ptr);
+            }
 
-    for (auto i = 0u; i < number_of_core_markers; ++i)
-    {
-        BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
+            auto datasource_name_offsets_ptr = layout.GetBlockPtr<std::size_t, true>(
+                memory_ptr, SharedDataLayout::DATASOURCE_NAME_OFFSETS);
+            if (layout.GetBlockSize(SharedDataLayout::DATASOURCE_NAME_OFFSETS) > 0)
+            {
+                std::copy(m_datasource_name_offsets.begin(), m_datasource_name_offsets.end(),
+                          datasource_name_offsets_ptr);
+            }
 
-        if (unpacked_core_markers[i] == 1)
+            auto datasource_name_lengths_ptr = layout.GetBlockPtr<std::size_t, true>(
+                memory_ptr, SharedDataLayout::DATASOURCE_NAME_LENGTHS);
+            if (layout.GetBlockSize(SharedDataLayout::DATASOURCE_NAME_LENGTHS) > 0)
+            {
+                std::copy(m_datasource_name_lengths.begin(), m_datasource_name_lengths.end(),
+                          datasource_name_lengths_ptr);
+            }
+        },
+        [&]
         {
-            const unsigned bucket = i / 32;
-            const unsigned offset = i % 32;
-            const unsigned value = [&]
+            // Loading list of coordinates
+            util::Coordinate *coordinates_ptr = layout.GetBlockPtr<util::Coordinate, true>(
+                memory_ptr, SharedDataLayout::COORDINATE_LIST);
+            char *packed_coordinates_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::PACKED_COORDINATE_LIST);
+            if (compress_geometries)
             {
-                unsigned return_value = 0;
-                if (0 != offset)
-                {
-                    return_value = core_marker_ptr[bucket];
-                }
-                return return_value;
-            }();
-
-            core_marker_ptr[bucket] = (value | (1u << offset));
-        }
-    }
+                packed_coordinates.Write(packed_coordinates_ptr);
+                return;
+            }
 
-    // load the nodes of the search graph
-    QueryGraph::NodeArrayEntry *graph_node_list_ptr =
-        shared_layout_ptr->GetBlockPtr<QueryGraph::NodeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_NODE_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST) > 0)
-    {
-        hsgr_input_stream.read((char *)graph_node_list_ptr,
-                               shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST));
-    }
+            readRecordsInBlocks<extractor::QueryNode>(
+                nodes_input_stream, coordinate_list_size,
+                [&](const std::size_t i, const extractor::QueryNode &current_node)
+                {
+                    coordinates_ptr[i] = util::Coordinate(current_node.lon, current_node.lat);
+                });
+            nodes_input_stream.close();
+        },
+        [&]
+        {
+            // store timestamp
+            char *timestamp_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::TIMESTAMP);
+            std::copy(m_timestamp.c_str(), m_timestamp.c_str() + m_timestamp.length(),
+                      timestamp_ptr);
 
-    // load the edges of the search graph
-    QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
-        shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST) > 0)
-    {
-        hsgr_input_stream.read((char *)graph_edge_list_ptr,
-                               shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST));
-    }
-    hsgr_input_stream.close();
+            // store search tree portion of rtree
+            char *rtree_ptr = layout.GetBlockPtr<char, true>(
+                memory_ptr, SharedDataLayout::R_SEARCH_TREE);
 
-    // load profile properties
-    auto profile_properties_ptr = shared_layout_ptr->GetBlockPtr<extractor::ProfileProperties, true>(shared_memory_ptr, SharedDataLayout::PROPERTIES);
-    boost::filesystem::ifstream profile_properties_stream(config.properties_path);
-    if (!profile_properties_stream)
-    {
-        util::exception("Could not open " + config.properties_path.string() + " for reading!");
-    }
-    profile_properties_stream.read(reinterpret_cast<char*>(profile_properties_ptr), sizeof(extractor::ProfileProperties));
+            if (tree_size > 0)
+            {
+                tree_node_file.read(rtree_ptr, sizeof(RTreeNode) * tree_size);
+            }
+            tree_node_file.close();
+        },
+        [&]
+        {
+            // load core markers
+            std::vector<char> unpacked_core_markers(number_of_core_markers);
+            core_marker_file.read((char *)unpacked_core_markers.data(),
+                                  sizeof(char) * number_of_core_markers);
 
-    // acquire lock
-    SharedMemory *data_type_memory =
-        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false);
-    SharedDataTimestamp *data_timestamp_ptr =
-        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
+            unsigned *core_marker_ptr = layout.GetBlockPtr<unsigned, true>(
+                memory_ptr, SharedDataLayout::CORE_MARKER);
 
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
+            for (auto i = 0u; i < number_of_core_markers; ++i)
+            {
+                BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
 
-    // notify all processes that were waiting for this condition
-    if (0 < barrier.number_of_queries)
-    {
-        barrier.no_running_queries_condition.wait(query_lock);
-    }
+                if (unpacked_core_markers[i] == 1)
+                {
+                    const unsigned bucket = i / 32;
+                    const unsigned offset = i % 32;
+                    const unsigned value = [&]
+                    {
+                        unsigned return_value = 0;
+                        if (0 != offset)
+                        {
+                            return_value = core_marker_ptr[bucket];
+                        }
+                        return return_value;
+                    }();
+
+                    core_marker_ptr[bucket] = (value | (1u << offset));
+                }
+            }
+        },
+        [&]
+        {
+            // load the nodes of the search graph
+            QueryGraph::NodeArrayEntry *graph_node_list_ptr =
+                layout.GetBlockPtr<QueryGraph::NodeArrayEntry, true>(
+                    memory_ptr, SharedDataLayout::GRAPH_NODE_LIST);
+            if (layout.GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST) > 0)
+            {
+                hsgr_input_stream.read(
+                    (char *)graph_node_list_ptr,
+                    layout.GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST));
+            }
 
-    data_timestamp_ptr->layout = layout_region;
-    data_timestamp_ptr->data = data_region;
-    data_timestamp_ptr->timestamp += 1;
-    deleteRegion(previous_data_region);
-    deleteRegion(previous_layout_region);
-    util::SimpleLogger().Write() << "all data loaded";
+            // load the edges of the search graph
+            QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
+                layout.GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
+                    memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
+            if (layout.GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST) > 0)
+            {
+                hsgr_input_stream.read(
+                    (char *)graph_edge_list_ptr,
+                    layout.GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST));
+            }
+            hsgr_input_stream.close();
+        },
+        [&]
+        {
+            // load profile properties
+            auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
+                memory_ptr, SharedDataLayout::PROPERTIES);
+            boost::filesystem::ifstream profile_properties_stream(config.properties_path);
+            if (!profile_properties_stream)
+            {
+                util::exception("Could not open " + config.properties_path.string() +
+                                " for reading!");
+            }
+            profile_properties_stream.read(reinterpret_cast<char *>(profile_properties_ptr),
+                                           sizeof(extractor::ProfileProperties));
+        });
+}
 
-    return EXIT_SUCCESS;
+// Copies every block of a container and checks it against its checksum on the way
+void Storage::CopyContainer(const DatasetContainer &container,
+                            const SharedDataLayout &layout,
+                            char *memory_ptr)
+{
+    tbb::parallel_for(0, static_cast<int>(SharedDataLayout::NUM_BLOCKS), [&](const int block)
+                      {
+                          const auto bid = static_cast<SharedDataLayout::BlockID>(block);
+                          if (!container.IsBlockValid(bid))
+                          {
+                              throw util::exception("Block " + std::to_string(block) +
+                                                    " of the dataset container is corrupted");
+                          }
+                          const char *source =
+                              container.GetLayout().GetBlockPtr<char>(container.GetDataPtr(), bid);
+                          std::copy(source, source + layout.GetBlockSize(bid),
+                                    layout.GetBlockPtr<char, true>(memory_ptr, bid));
+                      });
 }
 }
 }
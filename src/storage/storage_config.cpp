@@ -17,10 +17,20 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       names_data_path{base.string() + ".names"},
       properties_path{base.string() + ".properties"}
 {
+    if (base.extension() == ".dataset")
+    {
+        *this = StorageConfig();
+        dataset_path = base;
+    }
 }
 
 bool StorageConfig::IsValid() const
 {
+    if (!dataset_path.empty())
+    {
+        return boost::filesystem::is_regular_file(dataset_path);
+    }
+
     return boost::filesystem::is_regular_file(ram_index_path) &&
            boost::filesystem::is_regular_file(file_index_path) &&
            boost::filesystem::is_regular_file(hsgr_data_path) &&
@@ -1,5 +1,5 @@
 #include "util/typedefs.hpp"
-#include "extractor/tarjan_scc.hpp"
+#include "extractor/parallel_scc.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/dynamic_graph.hpp"
 #include "util/static_graph.hpp"
@@ -120,12 +120,12 @@ int main(int argc, char *argv[]) try
 
     osrm::util::SimpleLogger().Write() << "Starting SCC graph traversal";
 
-    auto tarjan =
-        osrm::util::make_unique<osrm::extractor::TarjanSCC<osrm::tools::TarjanGraph>>(graph);
-    tarjan->run();
-    osrm::util::SimpleLogger().Write() << "identified: " << tarjan->get_number_of_components()
+    auto scc =
+        osrm::util::make_unique<osrm::extractor::ParallelSCC<osrm::tools::TarjanGraph>>(graph);
+    scc->run();
+    osrm::util::SimpleLogger().Write() << "identified: " << scc->get_number_of_components()
                                        << " many components";
-    osrm::util::SimpleLogger().Write() << "identified " << tarjan->get_size_one_count()
+    osrm::util::SimpleLogger().Write() << "identified " << scc->get_size_one_count()
                                        << " size 1 SCCs";
 
     // output
@@ -187,8 +187,8 @@ int main(int argc, char *argv[]) try
                 BOOST_ASSERT(target != SPECIAL_NODEID);
 
                 const unsigned size_of_containing_component =
-                    std::min(tarjan->get_component_size(tarjan->get_component_id(source)),
-                             tarjan->get_component_size(tarjan->get_component_id(target)));
+                    std::min(scc->get_component_size(scc->get_component_id(source)),
+                             scc->get_component_size(scc->get_component_id(target)));
 
                 // edges that end on bollard nodes may actually be in two distinct components
                 if (size_of_containing_component < 1000)
@@ -45,7 +45,32 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         "Lookup files containing nodeA, nodeB, speed data to adjust edge weights")(
         "level-cache,o", boost::program_options::value<bool>(&contractor_config.use_cached_priority)
                              ->default_value(false),
-        "Use .level file to retain the contaction level for each node from the last run.");
+        "Use .level file to retain the contaction level for each node from the last run.")(
+        "nested-dissection",
+        boost::program_options::value<bool>(&contractor_config.use_nested_dissection)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Contract nodes in nested dissection order instead of by edge difference")(
+        "core-update",
+        boost::program_options::value<bool>(&contractor_config.update_core_only)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Only recontract the part of the previous hierarchy affected by changed edge weights")(
+        "core-update-radius",
+        boost::program_options::value<unsigned>(&contractor_config.core_update_radius)
+            ->default_value(2),
+        "Number of hops around changed edges that are recontracted with --core-update")(
+        "checkpoint-interval",
+        boost::program_options::value<unsigned>(&contractor_config.checkpoint_interval)
+            ->default_value(0),
+        "Write the contraction state to a .checkpoint file every N minutes (0 disables)")(
+        "resume", boost::program_options::value<bool>(&contractor_config.resume_from_checkpoint)
+                      ->implicit_value(true)
+                      ->default_value(false),
+        "Continue an interrupted run from its .checkpoint file")(
+        "contraction-stats",
+        boost::program_options::value<std::string>(&contractor_config.round_statistics_path),
+        "Write per-round contraction statistics as JSON lines to this file");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -122,6 +147,23 @@ int main(int argc, char *argv[]) try
         return EXIT_FAILURE;
     }
 
+    if (contractor_config.use_cached_priority && contractor_config.use_nested_dissection)
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "--level-cache and --nested-dissection both choose the contraction order, "
+               "use only one of them";
+        return EXIT_FAILURE;
+    }
+
+    if (contractor_config.update_core_only &&
+        (contractor_config.use_cached_priority || contractor_config.use_nested_dissection))
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "--core-update keeps the order of the previous contraction, it can't be used with "
+               "--level-cache or --nested-dissection";
+        return EXIT_FAILURE;
+    }
+
     const unsigned recommended_num_threads = tbb::task_scheduler_init::default_num_threads();
 
     if (recommended_num_threads != contractor_config.requested_num_threads)
@@ -47,7 +47,11 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         boost::program_options::value<unsigned int>(&extractor_config.small_component_size)
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
-        "(affects nearest neighbor snapping)");
+        "(affects nearest neighbor snapping)")(
+        "sort-memory",
+        boost::program_options::value<unsigned int>(&extractor_config.sort_memory_budget)
+            ->default_value(4096),
+        "Memory in MiB up to which data is sorted in memory instead of with stxxl");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -19,12 +19,16 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <iostream>
 #include <new>
 #include <thread>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -60,6 +64,8 @@ generateServerProgramOptions(const int argc,
                              int &ip_port,
                              int &requested_num_threads,
                              bool &use_shared_memory,
+                             bool &use_numa_replicas,
+                             std::vector<std::string> &datasets,
                              bool &trial,
                              int &max_locations_trip,
                              int &max_locations_viaroute,
@@ -87,6 +93,13 @@ generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("numa", value<bool>(&use_numa_replicas)->implicit_value(true)->default_value(false),
+         "Bind threads to NUMA nodes and load a copy of the data on each node") //
+        ("dataset", value<std::vector<std::string>>(&datasets)->composing(),
+         "Serve a dataset under the profile of its name instead of a single one, either as "
+         "<name> from the shared memory of osrm-datastore --dataset-name <name> or as "
+         "<name>=<base.osrm>. Can be given several times, an empty name serves all other "
+         "profiles.") //
         ("max-viaroute-size", value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
         ("max-trip-size", value<int>(&max_locations_trip)->default_value(100),
@@ -136,7 +149,15 @@ generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
-    if (!use_shared_memory && option_variables.count("base"))
+    if (!datasets.empty())
+    {
+        if (!use_shared_memory && !option_variables.count("base"))
+        {
+            return INIT_OK_START_ENGINE;
+        }
+        util::SimpleLogger().Write(logWARNING) << "Dataset settings conflict with path settings.";
+    }
+    else if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
     }
@@ -163,11 +184,12 @@ int main(int argc, const char *argv[]) try
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    std::vector<std::string> datasets;
     const unsigned init_result = generateServerProgramOptions(
         argc, argv, base_path, ip_address, ip_port, requested_thread_num,
-        config.use_shared_memory, trial_run, config.max_locations_trip,
-        config.max_locations_viaroute, config.max_locations_distance_table,
-        config.max_locations_map_matching);
+        config.use_shared_memory, config.use_numa_replicas, datasets, trial_run,
+        config.max_locations_trip, config.max_locations_viaroute,
+        config.max_locations_distance_table, config.max_locations_map_matching);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -180,7 +202,36 @@ int main(int argc, const char *argv[]) try
     {
         config.storage_config = storage::StorageConfig(base_path);
     }
-    if(!config.IsValid())
+
+    // every dataset shares the limits of the command line
+    std::unordered_map<std::string, EngineConfig> dataset_configs;
+    for (const auto &dataset : datasets)
+    {
+        const auto separator = dataset.find('=');
+        EngineConfig dataset_config = config;
+        dataset_config.dataset_name = dataset.substr(0, separator);
+        dataset_config.use_shared_memory = separator == std::string::npos;
+        if (!dataset_config.use_shared_memory)
+        {
+            dataset_config.storage_config = storage::StorageConfig(dataset.substr(separator + 1));
+        }
+        if (!dataset_config.IsValid())
+        {
+            util::SimpleLogger().Write(logWARNING) << "Invalid dataset " << dataset
+                                                   << ", names may only consist of letters and "
+                                                      "digits and paths need to exist";
+            return EXIT_FAILURE;
+        }
+        const auto dataset_name = dataset_config.dataset_name;
+        if (!dataset_configs.emplace(dataset_name, std::move(dataset_config)).second)
+        {
+            util::SimpleLogger().Write(logWARNING) << "Dataset " << dataset_name
+                                                   << " is given more than once";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (dataset_configs.empty() && !config.IsValid())
     {
         if (base_path.empty() != config.use_shared_memory)
         {
@@ -257,7 +308,11 @@ int main(int argc, const char *argv[]) try
                 (void)munlockall();
         }
         bool should_lock = false, could_lock = true;
-    } memory_locker(config.use_shared_memory);
+    } memory_locker(config.use_shared_memory ||
+                    std::any_of(dataset_configs.begin(), dataset_configs.end(),
+                                [](const std::pair<const std::string, EngineConfig> &dataset) {
+                                    return dataset.second.use_shared_memory;
+                                }));
 #endif
     util::SimpleLogger().Write() << "starting up engines, " << OSRM_VERSION;
 
@@ -265,6 +320,12 @@ int main(int argc, const char *argv[]) try
     {
         util::SimpleLogger().Write() << "Loading from shared memory";
     }
+    for (const auto &dataset : dataset_configs)
+    {
+        util::SimpleLogger().Write() << "Dataset \"" << dataset.first << "\" from "
+                                     << (dataset.second.use_shared_memory ? "shared memory"
+                                                                          : "files");
+    }
 
     util::SimpleLogger().Write() << "Threads: " << requested_thread_num;
     util::SimpleLogger().Write() << "IP address: " << ip_address;
@@ -278,8 +339,11 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
-    auto service_handler = util::make_unique<server::ServiceHandler>(config);
+    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num,
+                                                       config.use_numa_replicas);
+    auto service_handler = dataset_configs.empty()
+                               ? util::make_unique<server::ServiceHandler>(config)
+                               : util::make_unique<server::ServiceHandler>(dataset_configs);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
@@ -1,3 +1,4 @@
+#include "storage/shared_memory.hpp"
 #include "storage/storage.hpp"
 #include "util/exception.hpp"
 #include "util/simple_logger.hpp"
@@ -7,10 +8,19 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <string>
+
 using namespace osrm;
 
 // generate boost::program_options object for the routing part
-bool generateDataStoreOptions(const int argc, const char *argv[], boost::filesystem::path& base_path)
+bool generateDataStoreOptions(const int argc,
+                              const char *argv[],
+                              boost::filesystem::path &base_path,
+                              boost::filesystem::path &container_path,
+                              bool &use_huge_pages,
+                              std::string &dataset_name,
+                              bool &report_resident_size,
+                              bool &compress_geometries)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -20,6 +30,32 @@ bool generateDataStoreOptions(const int argc, const char *argv[], boost::filesys
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
     boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "huge-pages",
+        boost::program_options::value<bool>(&use_huge_pages)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Back the data region with huge pages, which need to be reserved beforehand (Linux only)")(
+        "write-dataset",
+        boost::program_options::value<boost::filesystem::path>(&container_path),
+        "Write the dataset into a single <file>.dataset instead of loading it into shared memory. "
+        "Passing that file instead of the .osrm file loads it.")(
+        "dataset-name",
+        boost::program_options::value<std::string>(&dataset_name),
+        "Load into the shared memory of the named dataset, which osrm-routed serves under the "
+        "profile of the same name. Datasets of different names are updated independently.")(
+        "resident-size",
+        boost::program_options::value<bool>(&report_resident_size)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Report how much of every block of the loaded dataset, or of the given .dataset file, is "
+        "in memory instead of loading it (Linux only)")(
+        "compress-geometries",
+        boost::program_options::value<bool>(&compress_geometries)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store coordinates and geometries delta encoded. Takes about half the memory, but every "
+        "lookup has to decode up to 16 varint encoded pairs.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -77,17 +113,42 @@ int main(const int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     boost::filesystem::path base_path;
-    if (!generateDataStoreOptions(argc, argv, base_path))
+    boost::filesystem::path container_path;
+    bool use_huge_pages = false;
+    std::string dataset_name;
+    bool report_resident_size = false;
+    bool compress_geometries = false;
+    if (!generateDataStoreOptions(argc, argv, base_path, container_path, use_huge_pages,
+                                  dataset_name, report_resident_size, compress_geometries))
     {
         return EXIT_SUCCESS;
     }
+    if (!storage::IsValidDatasetName(dataset_name))
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "Dataset names may only consist of letters and digits";
+        return EXIT_FAILURE;
+    }
     storage::StorageConfig config(base_path);
+    if (report_resident_size)
+    {
+        return storage::Storage(std::move(config), false, dataset_name).ReportResidentSize();
+    }
     if (!config.IsValid())
     {
         util::SimpleLogger().Write(logWARNING) << "Invalid file path given!";
         return EXIT_FAILURE;
     }
-    storage::Storage storage(std::move(config));
+    if (!container_path.empty() && !config.dataset_path.empty())
+    {
+        util::SimpleLogger().Write(logWARNING) << "Can only write a dataset from .osrm files";
+        return EXIT_FAILURE;
+    }
+    storage::Storage storage(std::move(config), use_huge_pages, dataset_name, compress_geometries);
+    if (!container_path.empty())
+    {
+        return storage.WriteContainer(container_path);
+    }
     return storage.Run();
 }
 catch (const std::bad_alloc &e)
@@ -9,8 +9,6 @@ int main() try
     osrm::util::SimpleLogger().Write() << "Releasing all locks";
     osrm::storage::SharedBarriers barrier;
     barrier.pending_update_mutex.unlock();
-    barrier.query_mutex.unlock();
-    barrier.update_mutex.unlock();
     return 0;
 }
 catch (const std::exception &e)
@@ -0,0 +1,99 @@
+#include "contractor/contractor.hpp"
+#include "contractor/graph_contractor.hpp"
+
+#include "helper.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(checkpoint)
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::unit_test;
+
+namespace
+{
+// Loads the edge-expanded graph like osrm-contract does. The order of the edges decides which
+// of two merged parallel edges keeps its id, so a checkpoint has to start from the same list.
+class LoadingContractor : public Contractor
+{
+  public:
+    using Contractor::Contractor;
+
+    std::size_t LoadEdges(const ContractorConfig &config,
+                          util::DeallocatingVector<extractor::EdgeBasedEdge> &edges)
+    {
+        return LoadEdgeExpandedGraph(
+            config.edge_based_graph_path, edges, config.edge_segment_lookup_path,
+            config.edge_penalty_path, config.segment_speed_lookup_paths,
+            config.node_based_graph_path, config.geometry_path, config.datasource_names_path,
+            config.datasource_indexes_path, config.rtree_leaf_path);
+    }
+};
+
+// Contracts the dataset, then resumes from a checkpoint of the same contraction and checks
+// that the resumed run writes the same files
+void CheckResumedRun(const ContractorDataset &dataset, const std::vector<float> &cached_levels)
+{
+    Contractor(dataset.config).Run();
+    const auto expected_graph =
+        ContractorDataset::ReadContractedGraph(dataset.config.graph_output_path);
+    const auto expected_levels = ContractorDataset::ReadFile(dataset.config.level_output_path);
+    const auto expected_core = ContractorDataset::ReadFile(dataset.config.core_output_path);
+    BOOST_REQUIRE(!expected_graph.empty());
+    BOOST_REQUIRE(!expected_levels.empty());
+
+    {
+        // checkpoints after every round, the last one stays behind like after an interruption
+        util::DeallocatingVector<extractor::EdgeBasedEdge> edges;
+        const auto max_edge_id = LoadingContractor(dataset.config).LoadEdges(dataset.config, edges);
+        GraphContractor graph_contractor(max_edge_id + 1, edges,
+                                         std::vector<float>(cached_levels),
+                                         std::vector<EdgeWeight>(dataset.node_weights));
+        graph_contractor.EnableCheckpoints(dataset.config.checkpoint_path, 0);
+        graph_contractor.Run(dataset.config.core_factor);
+    }
+    BOOST_REQUIRE(boost::filesystem::exists(dataset.config.checkpoint_path));
+    boost::filesystem::remove(dataset.config.graph_output_path);
+    boost::filesystem::remove(dataset.config.core_output_path);
+
+    // the resuming command line doesn't repeat how the levels were chosen
+    auto resume_config = dataset.config;
+    resume_config.resume_from_checkpoint = true;
+    resume_config.use_cached_priority = false;
+    resume_config.use_nested_dissection = false;
+    Contractor(resume_config).Run();
+
+    BOOST_CHECK(ContractorDataset::ReadContractedGraph(dataset.config.graph_output_path) ==
+                expected_graph);
+    BOOST_CHECK(ContractorDataset::ReadFile(dataset.config.level_output_path) == expected_levels);
+    BOOST_CHECK(ContractorDataset::ReadFile(dataset.config.core_output_path) == expected_core);
+    BOOST_CHECK(!boost::filesystem::exists(dataset.config.checkpoint_path));
+}
+}
+
+BOOST_AUTO_TEST_CASE(resume_with_computed_levels)
+{
+    const ContractorDataset dataset(12, 10);
+    CheckResumedRun(dataset, {});
+}
+
+BOOST_AUTO_TEST_CASE(resume_keeps_cached_levels)
+{
+    ContractorDataset dataset(12, 10);
+    std::vector<float> cached_levels(dataset.number_of_nodes);
+    for (unsigned node = 0; node < dataset.number_of_nodes; ++node)
+    {
+        cached_levels[node] = (node * 37) % dataset.number_of_nodes;
+    }
+    dataset.WriteNodeLevels(cached_levels);
+    dataset.config.use_cached_priority = true;
+
+    CheckResumedRun(dataset, cached_levels);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+#ifndef UNIT_TESTS_CONTRACTOR_HELPER_HPP
+#define UNIT_TESTS_CONTRACTOR_HELPER_HPP
+
+#include "contractor/contractor_config.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/fingerprint.hpp"
+#include "util/io.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace unit_test
+{
+
+// Edge-expanded grid graph in the files osrm-contract reads, in a temporary directory
+struct ContractorDataset
+{
+    ContractorDataset(const unsigned width, const unsigned height)
+        : directory(boost::filesystem::temp_directory_path() /
+                    boost::filesystem::unique_path("contractor-%%%%-%%%%")),
+          number_of_nodes(width * height), node_weights(number_of_nodes, 1)
+    {
+        const auto add_edge = [this](const NodeID from, const NodeID to) {
+            // varied, but deterministic weights
+            const EdgeWeight weight = 10 + (from * 7 + to * 13) % 23;
+            edges.emplace_back(from, to, static_cast<NodeID>(edges.size()), weight, true, false);
+        };
+        for (unsigned y = 0; y < height; ++y)
+        {
+            for (unsigned x = 0; x < width; ++x)
+            {
+                const NodeID node = y * width + x;
+                if (x + 1 < width)
+                {
+                    add_edge(node, node + 1);
+                    add_edge(node + 1, node);
+                }
+                if (y + 1 < height)
+                {
+                    add_edge(node, node + width);
+                    add_edge(node + width, node);
+                }
+            }
+        }
+
+        boost::filesystem::create_directory(directory);
+        config.osrm_input_path = directory / "graph.osrm";
+        config.UseDefaultOutputNames();
+        config.use_cached_priority = false;
+        config.core_factor = 1.0;
+        Write();
+    }
+
+    ~ContractorDataset() { boost::filesystem::remove_all(directory); }
+
+    // (Re)writes the edge-expanded graph and the node weights
+    void Write() const
+    {
+        boost::filesystem::ofstream stream(config.edge_based_graph_path, std::ios::binary);
+        util::writeFingerprint(stream);
+        const std::size_t number_of_edges = edges.size();
+        const std::size_t max_edge_id = number_of_nodes - 1;
+        stream.write(reinterpret_cast<const char *>(&number_of_edges), sizeof(number_of_edges));
+        stream.write(reinterpret_cast<const char *>(&max_edge_id), sizeof(max_edge_id));
+        stream.write(reinterpret_cast<const char *>(edges.data()),
+                     edges.size() * sizeof(extractor::EdgeBasedEdge));
+
+        util::serializeVector(config.osrm_input_path.string() + ".enw", node_weights);
+    }
+
+    // DeallocatingVector can't be copied safely, so it is filled in place
+    void GetEdges(util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_list) const
+    {
+        for (const auto &edge : edges)
+        {
+            edge_list.push_back(edge);
+        }
+    }
+
+    void WriteNodeLevels(const std::vector<float> &node_levels) const
+    {
+        boost::filesystem::ofstream stream(config.level_output_path, std::ios::binary);
+        const unsigned number_of_levels = node_levels.size();
+        stream.write(reinterpret_cast<const char *>(&number_of_levels), sizeof(number_of_levels));
+        stream.write(reinterpret_cast<const char *>(node_levels.data()),
+                     node_levels.size() * sizeof(float));
+    }
+
+    static std::vector<float> ReadNodeLevels(const boost::filesystem::path &path)
+    {
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        unsigned number_of_levels = 0;
+        stream.read(reinterpret_cast<char *>(&number_of_levels), sizeof(number_of_levels));
+        std::vector<float> node_levels(number_of_levels);
+        stream.read(reinterpret_cast<char *>(node_levels.data()),
+                    node_levels.size() * sizeof(float));
+        return node_levels;
+    }
+
+    // source, target, distance, id, shortcut, forward, backward
+    using ContractedEdge = std::tuple<NodeID, NodeID, int, unsigned, bool, bool, bool>;
+
+    // Edges of a .hsgr file in a canonical order, edges of a node are stored in no
+    // particular order
+    static std::vector<ContractedEdge> ReadContractedGraph(const boost::filesystem::path &path)
+    {
+        using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        stream.seekg(sizeof(util::FingerPrint) + sizeof(unsigned));
+        unsigned number_of_nodes = 0;
+        unsigned number_of_edges = 0;
+        stream.read(reinterpret_cast<char *>(&number_of_nodes), sizeof(number_of_nodes));
+        stream.read(reinterpret_cast<char *>(&number_of_edges), sizeof(number_of_edges));
+        std::vector<QueryGraph::NodeArrayEntry> nodes(number_of_nodes);
+        std::vector<QueryGraph::EdgeArrayEntry> edges(number_of_edges);
+        stream.read(reinterpret_cast<char *>(nodes.data()),
+                    nodes.size() * sizeof(QueryGraph::NodeArrayEntry));
+        stream.read(reinterpret_cast<char *>(edges.data()),
+                    edges.size() * sizeof(QueryGraph::EdgeArrayEntry));
+
+        std::vector<ContractedEdge> result;
+        for (NodeID node = 0; node + 1 < number_of_nodes; ++node)
+        {
+            for (auto edge = nodes[node].first_edge; edge < nodes[node + 1].first_edge; ++edge)
+            {
+                const auto &data = edges[edge].data;
+                result.emplace_back(node, edges[edge].target, static_cast<int>(data.distance),
+                                    static_cast<unsigned>(data.id), data.shortcut, data.forward,
+                                    data.backward);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    static std::string ReadFile(const boost::filesystem::path &path)
+    {
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream),
+                           std::istreambuf_iterator<char>());
+    }
+
+    boost::filesystem::path directory;
+    unsigned number_of_nodes;
+    std::vector<extractor::EdgeBasedEdge> edges;
+    std::vector<EdgeWeight> node_weights;
+    contractor::ContractorConfig config;
+};
+}
+}
+
+#endif
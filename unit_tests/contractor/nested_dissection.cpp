@@ -0,0 +1,165 @@
+#include "contractor/nested_dissection.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <functional>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(nested_dissection)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+using EdgeList = util::DeallocatingVector<extractor::EdgeBasedEdge>;
+using AdjacencyList = std::vector<std::vector<NodeID>>;
+
+// Adds a width x height grid of nodes starting at first_node
+void AddGrid(const NodeID first_node,
+             const unsigned width,
+             const unsigned height,
+             EdgeList &edges,
+             AdjacencyList &adjacency)
+{
+    const auto add_edge = [&](const NodeID from, const NodeID to) {
+        edges.push_back(extractor::EdgeBasedEdge(from, to, edges.size(), 10, true, false));
+        adjacency[from].push_back(to);
+        adjacency[to].push_back(from);
+    };
+    for (unsigned y = 0; y < height; ++y)
+    {
+        for (unsigned x = 0; x < width; ++x)
+        {
+            const NodeID node = first_node + y * width + x;
+            if (x + 1 < width)
+            {
+                add_edge(node, node + 1);
+            }
+            if (y + 1 < height)
+            {
+                add_edge(node, node + width);
+            }
+        }
+    }
+}
+
+// Removing the nodes of a separator splits its cell, whose nodes are all on lower levels. So
+// every separator node has neighbours in two components of the nodes on lower levels.
+void CheckSeparators(const AdjacencyList &adjacency, const std::vector<float> &levels)
+{
+    const NodeID number_of_nodes = adjacency.size();
+    for (NodeID separator_node = 0; separator_node < number_of_nodes; ++separator_node)
+    {
+        const float level = std::floor(levels[separator_node]);
+        if (level < 1)
+        {
+            continue;
+        }
+
+        std::vector<int> component(number_of_nodes, -1);
+        const std::function<void(NodeID, int)> mark = [&](const NodeID start, const int id) {
+            std::vector<NodeID> stack(1, start);
+            component[start] = id;
+            while (!stack.empty())
+            {
+                const auto node = stack.back();
+                stack.pop_back();
+                for (const auto target : adjacency[node])
+                {
+                    if (component[target] < 0 && levels[target] < level)
+                    {
+                        component[target] = id;
+                        stack.push_back(target);
+                    }
+                }
+            }
+        };
+
+        std::set<int> neighbour_components;
+        for (const auto target : adjacency[separator_node])
+        {
+            if (levels[target] >= level)
+            {
+                continue;
+            }
+            if (component[target] < 0)
+            {
+                mark(target, target);
+            }
+            neighbour_components.insert(component[target]);
+        }
+        BOOST_CHECK_GE(neighbour_components.size(), 2u);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(every_node_gets_a_level)
+{
+    // two grids that are not connected to each other
+    const NodeID number_of_nodes = 30 * 30 + 20 * 10;
+    EdgeList edges;
+    AdjacencyList adjacency(number_of_nodes);
+    AddGrid(0, 30, 30, edges, adjacency);
+    AddGrid(30 * 30, 20, 10, edges, adjacency);
+
+    const auto levels = NestedDissection(number_of_nodes, edges).ComputeNodeLevels();
+    BOOST_REQUIRE_EQUAL(levels.size(), number_of_nodes);
+
+    unsigned number_of_separator_nodes = 0;
+    for (const auto level : levels)
+    {
+        BOOST_CHECK(std::isfinite(level));
+        BOOST_CHECK_GE(level, 0.f);
+        number_of_separator_nodes += level >= 1 ? 1 : 0;
+    }
+    // the large grid is dissected, but most nodes stay in leaf cells
+    BOOST_CHECK_GT(number_of_separator_nodes, 0u);
+    BOOST_CHECK_LT(number_of_separator_nodes, number_of_nodes / 2);
+}
+
+BOOST_AUTO_TEST_CASE(separators_rank_above_their_cells)
+{
+    const NodeID number_of_nodes = 40 * 25;
+    EdgeList edges;
+    AdjacencyList adjacency(number_of_nodes);
+    AddGrid(0, 40, 25, edges, adjacency);
+
+    const auto levels = NestedDissection(number_of_nodes, edges).ComputeNodeLevels();
+    BOOST_REQUIRE_EQUAL(levels.size(), number_of_nodes);
+    CheckSeparators(adjacency, levels);
+}
+
+BOOST_AUTO_TEST_CASE(low_degree_nodes_go_first)
+{
+    // a 5x5 grid is a single leaf cell
+    const NodeID number_of_nodes = 5 * 5;
+    EdgeList edges;
+    AdjacencyList adjacency(number_of_nodes);
+    AddGrid(0, 5, 5, edges, adjacency);
+
+    const auto levels = NestedDissection(number_of_nodes, edges).ComputeNodeLevels();
+    BOOST_REQUIRE_EQUAL(levels.size(), number_of_nodes);
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        BOOST_CHECK_LT(levels[node], 1.f);
+        for (NodeID other = 0; other < number_of_nodes; ++other)
+        {
+            if (adjacency[node].size() < adjacency[other].size())
+            {
+                BOOST_CHECK_LT(levels[node], levels[other]);
+            }
+        }
+    }
+    // corner, border and inner nodes
+    BOOST_CHECK_LT(levels[0], levels[1]);
+    BOOST_CHECK_LT(levels[1], levels[6]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
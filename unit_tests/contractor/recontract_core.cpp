@@ -0,0 +1,155 @@
+#include "contractor/contractor.hpp"
+
+#include "helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(recontract_core)
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::unit_test;
+
+namespace
+{
+const constexpr int INVALID_DISTANCE = std::numeric_limits<int>::max();
+
+// target, distance
+using Adjacency = std::vector<std::vector<std::pair<NodeID, int>>>;
+
+std::vector<int> Dijkstra(const Adjacency &adjacency, const NodeID source)
+{
+    using HeapEntry = std::pair<int, NodeID>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    std::vector<int> distances(adjacency.size(), INVALID_DISTANCE);
+    distances[source] = 0;
+    heap.emplace(0, source);
+    while (!heap.empty())
+    {
+        const auto distance = heap.top().first;
+        const auto node = heap.top().second;
+        heap.pop();
+        if (distance > distances[node])
+        {
+            continue;
+        }
+        for (const auto &edge : adjacency[node])
+        {
+            if (distance + edge.second < distances[edge.first])
+            {
+                distances[edge.first] = distance + edge.second;
+                heap.emplace(distances[edge.first], edge.first);
+            }
+        }
+    }
+    return distances;
+}
+
+// Distances between all pairs of nodes as the query answers them on the contracted graph:
+// an upward search from the source meets a reversed upward search from the target
+std::vector<std::vector<int>> HierarchyDistances(const ContractorDataset &dataset)
+{
+    const auto graph = ContractorDataset::ReadContractedGraph(dataset.config.graph_output_path);
+    Adjacency forward(dataset.number_of_nodes);
+    Adjacency backward(dataset.number_of_nodes);
+    for (const auto &edge : graph)
+    {
+        if (std::get<5>(edge))
+        {
+            forward[std::get<0>(edge)].emplace_back(std::get<1>(edge), std::get<2>(edge));
+        }
+        if (std::get<6>(edge))
+        {
+            backward[std::get<0>(edge)].emplace_back(std::get<1>(edge), std::get<2>(edge));
+        }
+    }
+
+    std::vector<std::vector<int>> backward_distances;
+    for (NodeID target = 0; target < dataset.number_of_nodes; ++target)
+    {
+        backward_distances.push_back(Dijkstra(backward, target));
+    }
+
+    std::vector<std::vector<int>> distances;
+    for (NodeID source = 0; source < dataset.number_of_nodes; ++source)
+    {
+        const auto forward_distances = Dijkstra(forward, source);
+        distances.emplace_back(dataset.number_of_nodes, INVALID_DISTANCE);
+        for (NodeID target = 0; target < dataset.number_of_nodes; ++target)
+        {
+            for (NodeID middle = 0; middle < dataset.number_of_nodes; ++middle)
+            {
+                if (forward_distances[middle] != INVALID_DISTANCE &&
+                    backward_distances[target][middle] != INVALID_DISTANCE)
+                {
+                    distances[source][target] =
+                        std::min(distances[source][target],
+                                 forward_distances[middle] + backward_distances[target][middle]);
+                }
+            }
+        }
+    }
+    return distances;
+}
+
+// Distances between all pairs of nodes in the edge-expanded graph
+std::vector<std::vector<int>> GraphDistances(const ContractorDataset &dataset)
+{
+    Adjacency adjacency(dataset.number_of_nodes);
+    for (const auto &edge : dataset.edges)
+    {
+        adjacency[edge.source].emplace_back(edge.target, edge.weight);
+    }
+    std::vector<std::vector<int>> distances;
+    for (NodeID source = 0; source < dataset.number_of_nodes; ++source)
+    {
+        distances.push_back(Dijkstra(adjacency, source));
+    }
+    return distances;
+}
+}
+
+BOOST_AUTO_TEST_CASE(recontracted_core_keeps_distances)
+{
+    ContractorDataset dataset(10, 8);
+    Contractor(dataset.config).Run();
+    BOOST_REQUIRE(HierarchyDistances(dataset) == GraphDistances(dataset));
+    const auto previous_levels =
+        ContractorDataset::ReadNodeLevels(dataset.config.level_output_path);
+
+    // one edge in the middle of the grid gets slower, another one faster
+    dataset.edges[70].weight += 40;
+    dataset.edges[75].weight = 1;
+    dataset.Write();
+
+    auto update_config = dataset.config;
+    update_config.update_core_only = true;
+    Contractor(update_config).Run();
+    const auto updated_distances = HierarchyDistances(dataset);
+
+    // only a part of the hierarchy was contracted again, the rest keeps its levels
+    const auto updated_levels =
+        ContractorDataset::ReadNodeLevels(dataset.config.level_output_path);
+    BOOST_REQUIRE_EQUAL(updated_levels.size(), previous_levels.size());
+    unsigned number_of_kept_nodes = 0;
+    for (NodeID node = 0; node < dataset.number_of_nodes; ++node)
+    {
+        number_of_kept_nodes += updated_levels[node] == previous_levels[node] ? 1 : 0;
+    }
+    BOOST_CHECK_GT(number_of_kept_nodes, 0u);
+    BOOST_CHECK_LT(number_of_kept_nodes, dataset.number_of_nodes);
+
+    Contractor(dataset.config).Run();
+    const auto recontracted_distances = HierarchyDistances(dataset);
+
+    BOOST_CHECK(updated_distances == recontracted_distances);
+    BOOST_CHECK(updated_distances == GraphDistances(dataset));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
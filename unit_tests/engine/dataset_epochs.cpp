@@ -0,0 +1,184 @@
+#include "engine/dataset_epochs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(dataset_epochs)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Runs tasks one after the other on a thread that stays alive in between
+class Worker
+{
+  public:
+    Worker() : task(nullptr), stopped(false), thread([this] { Loop(); }) {}
+
+    ~Worker()
+    {
+        Run([this] { stopped = true; });
+        thread.join();
+    }
+
+    void Run(const std::function<void()> &next_task)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        task = &next_task;
+        condition.notify_all();
+        condition.wait(lock, [this] { return task == nullptr; });
+    }
+
+  private:
+    void Loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopped)
+        {
+            condition.wait(lock, [this] { return task != nullptr; });
+            (*task)();
+            task = nullptr;
+            condition.notify_all();
+        }
+    }
+
+    const std::function<void()> *task;
+    bool stopped;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread thread;
+};
+}
+
+BOOST_AUTO_TEST_CASE(readers_are_not_blocked_by_synchronize)
+{
+    DatasetEpochs epochs;
+    Worker old_reader;
+    std::unique_ptr<DatasetEpochs::ReadGuard> old_pin;
+    old_reader.Run([&] { old_pin.reset(new DatasetEpochs::ReadGuard(epochs)); });
+
+    std::atomic<bool> synchronized(false);
+    std::thread writer([&] {
+        epochs.Synchronize();
+        synchronized.store(true);
+    });
+
+    // readers arriving while the writer waits pin the new generation
+    for (int i = 0; i < 100; ++i)
+    {
+        const DatasetEpochs::ReadGuard pin(epochs);
+    }
+    std::thread new_reader([&] {
+        const DatasetEpochs::ReadGuard pin(epochs);
+    });
+    new_reader.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(!synchronized.load());
+
+    old_reader.Run([&] { old_pin.reset(); });
+    writer.join();
+    BOOST_CHECK(synchronized.load());
+}
+
+BOOST_AUTO_TEST_CASE(synchronize_waits_for_readers_of_swapped_data)
+{
+    DatasetEpochs epochs;
+    std::atomic<std::vector<int> *> current(new std::vector<int>(64, 0));
+
+    std::atomic<bool> done(false);
+    std::atomic<int> inconsistent_reads(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&] {
+            while (!done.load())
+            {
+                const DatasetEpochs::ReadGuard pin(epochs);
+                const auto &dataset = *current.load();
+                for (const auto value : dataset)
+                {
+                    // freed data would have been overwritten first
+                    if (value != dataset.front() || value < 0)
+                    {
+                        ++inconsistent_reads;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int generation = 1; generation <= 200; ++generation)
+    {
+        auto *previous = current.exchange(new std::vector<int>(64, generation));
+        epochs.Synchronize();
+        std::fill(previous->begin(), previous->end(), -1);
+        delete previous;
+    }
+    done.store(true);
+
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    delete current.load();
+    BOOST_CHECK_EQUAL(inconsistent_reads.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(slots_are_reused)
+{
+    DatasetEpochs epochs;
+    for (int i = 0; i < 16; ++i)
+    {
+        std::thread reader([&epochs] {
+            const DatasetEpochs::ReadGuard pin(epochs);
+        });
+        reader.join();
+    }
+
+    // a writer must not wait for exited readers
+    epochs.Synchronize();
+}
+
+BOOST_AUTO_TEST_CASE(reader_outlives_epochs)
+{
+    // a new DatasetEpochs at the address of a destroyed one
+    std::aligned_storage<sizeof(DatasetEpochs), alignof(DatasetEpochs)>::type storage;
+    Worker reader;
+
+    auto *epochs = new (&storage) DatasetEpochs();
+    reader.Run([epochs] { const DatasetEpochs::ReadGuard pin(*epochs); });
+    epochs->~DatasetEpochs();
+
+    epochs = new (&storage) DatasetEpochs();
+    std::unique_ptr<DatasetEpochs::ReadGuard> pin;
+    reader.Run([&] { pin.reset(new DatasetEpochs::ReadGuard(*epochs)); });
+
+    // the pin of the living thread has to hold back the writer of the new instance
+    std::atomic<bool> synchronized(false);
+    std::thread writer([&] {
+        epochs->Synchronize();
+        synchronized.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(!synchronized.load());
+    reader.Run([&] { pin.reset(); });
+    writer.join();
+    BOOST_CHECK(synchronized.load());
+
+    // the thread exits after the instance it pinned is gone
+    epochs->~DatasetEpochs();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 BOOST_AUTO_TEST_SUITE(graph_compressor)
@@ -203,4 +204,91 @@ BOOST_AUTO_TEST_CASE(direction_changes)
     BOOST_CHECK(graph.FindEdge(1, 2) != SPECIAL_EDGEID);
 }
 
+BOOST_AUTO_TEST_CASE(barriers_and_traffic_lights)
+{
+    //
+    // 0---1---2---3---4---5---6
+    //         ^       |
+    //   traffic light  barrier
+    //
+    GraphCompressor compressor;
+
+    std::unordered_set<NodeID> barrier_nodes = {4};
+    std::unordered_set<NodeID> traffic_lights = {2};
+    RestrictionMap map;
+    CompressedEdgeContainer container;
+
+    std::vector<InputEdge> edges;
+    for (NodeID node = 0; node + 1 < 7; ++node)
+    {
+        // src, tgt, dist, edge_id, name_id, access_restricted, fwd, bkwd, roundabout, travel_mode
+        edges.push_back({node, node + 1, 1, SPECIAL_EDGEID, 0, false, false, false, true,
+                         TRAVEL_MODE_INACCESSIBLE});
+        edges.push_back({node + 1, node, 1, SPECIAL_EDGEID, 0, false, false, false, true,
+                         TRAVEL_MODE_INACCESSIBLE});
+    }
+    std::sort(edges.begin(), edges.end());
+
+    Graph graph(7, edges);
+    compressor.Compress(barrier_nodes, traffic_lights, map, graph, container);
+
+    BOOST_CHECK_EQUAL(graph.FindEdge(0, 1), SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.FindEdge(2, 3), SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.FindEdge(4, 5), SPECIAL_EDGEID);
+    BOOST_CHECK(graph.FindEdge(0, 2) != SPECIAL_EDGEID);
+    BOOST_CHECK(graph.FindEdge(2, 4) != SPECIAL_EDGEID);
+    BOOST_CHECK(graph.FindEdge(4, 6) != SPECIAL_EDGEID);
+    BOOST_CHECK(graph.FindEdge(6, 4) != SPECIAL_EDGEID);
+}
+
+BOOST_AUTO_TEST_CASE(long_chain)
+{
+    //
+    // 0---1---2--- ... ---999
+    //
+    // long enough for the candidate scan to be split up
+    GraphCompressor compressor;
+
+    std::unordered_set<NodeID> barrier_nodes;
+    std::unordered_set<NodeID> traffic_lights;
+    RestrictionMap map;
+    CompressedEdgeContainer container;
+
+    const NodeID number_of_nodes = 1000;
+    std::vector<InputEdge> edges;
+    for (NodeID node = 0; node + 1 < number_of_nodes; ++node)
+    {
+        // src, tgt, dist, edge_id, name_id, access_restricted, fwd, bkwd, roundabout, travel_mode
+        edges.push_back({node, node + 1, 1, SPECIAL_EDGEID, 0, false, false, false, true,
+                         TRAVEL_MODE_INACCESSIBLE});
+        edges.push_back({node + 1, node, 1, SPECIAL_EDGEID, 0, false, false, false, true,
+                         TRAVEL_MODE_INACCESSIBLE});
+    }
+    std::sort(edges.begin(), edges.end());
+
+    Graph graph(number_of_nodes, edges);
+    compressor.Compress(barrier_nodes, traffic_lights, map, graph, container);
+
+    for (NodeID node = 1; node + 1 < number_of_nodes; ++node)
+    {
+        BOOST_CHECK_EQUAL(graph.GetOutDegree(node), 0);
+    }
+    const auto forward_edge = graph.FindEdge(0, number_of_nodes - 1);
+    const auto reverse_edge = graph.FindEdge(number_of_nodes - 1, 0);
+    BOOST_REQUIRE(forward_edge != SPECIAL_EDGEID);
+    BOOST_REQUIRE(reverse_edge != SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(forward_edge).distance, number_of_nodes - 1);
+
+    // the geometry lists every node after the source, in order
+    BOOST_REQUIRE(container.HasEntryForID(forward_edge));
+    const auto &geometry = container.GetBucketReference(forward_edge);
+    BOOST_REQUIRE_EQUAL(geometry.size(), number_of_nodes - 1);
+    for (NodeID index = 0; index < geometry.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(geometry[index].node_id, index + 1);
+    }
+    BOOST_REQUIRE(container.HasEntryForID(reverse_edge));
+    BOOST_CHECK_EQUAL(container.GetFirstEdgeTargetID(reverse_edge), number_of_nodes - 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+#include "extractor/name_interner.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(name_interner)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+BOOST_AUTO_TEST_CASE(sequential_ids)
+{
+    NameInterner interner;
+
+    BOOST_CHECK_EQUAL(interner.Intern(""), 0);
+    BOOST_CHECK_EQUAL(interner.Intern("Main Street"), 1);
+    BOOST_CHECK_EQUAL(interner.Intern("Broadway"), 2);
+    BOOST_CHECK_EQUAL(interner.Intern("Main Street"), 1);
+    BOOST_CHECK_EQUAL(interner.GetNumberOfNames(), 3);
+
+    const std::vector<unsigned> expected_lengths = {0, 11, 8};
+    const auto lengths = interner.GetNameLengths();
+    BOOST_CHECK_EQUAL_COLLECTIONS(lengths.begin(), lengths.end(), expected_lengths.begin(),
+                                  expected_lengths.end());
+
+    std::stringstream data;
+    interner.WriteNameData(data);
+    BOOST_CHECK_EQUAL(data.str(), "Main StreetBroadway");
+}
+
+BOOST_AUTO_TEST_CASE(long_names)
+{
+    NameInterner interner;
+
+    const std::string long_name(300, 'a');
+    const std::string other_long_name = long_name + "b";
+    const std::string huge_name(100 * 1024, 'c');
+
+    BOOST_CHECK_EQUAL(interner.Intern(long_name), 1);
+    // deduplicated by the full name, even if the stored prefix is the same
+    BOOST_CHECK_EQUAL(interner.Intern(other_long_name), 2);
+    BOOST_CHECK_EQUAL(interner.Intern(huge_name), 3);
+    BOOST_CHECK_EQUAL(interner.Intern("after huge"), 4);
+    BOOST_CHECK_EQUAL(interner.Intern(huge_name), 3);
+
+    const auto lengths = interner.GetNameLengths();
+    BOOST_CHECK_EQUAL(lengths[1], NameInterner::MAX_NAME_LENGTH);
+    BOOST_CHECK_EQUAL(lengths[2], NameInterner::MAX_NAME_LENGTH);
+    BOOST_CHECK_EQUAL(lengths[3], NameInterner::MAX_NAME_LENGTH);
+    BOOST_CHECK_EQUAL(lengths[4], 10);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_interning)
+{
+    NameInterner interner;
+
+    const unsigned number_of_names = 10000;
+    std::vector<unsigned> ids(4 * number_of_names);
+    tbb::parallel_for(0u, static_cast<unsigned>(ids.size()), [&](const unsigned index)
+                      {
+                          ids[index] = interner.Intern("name " +
+                                                       std::to_string(index % number_of_names));
+                      });
+
+    BOOST_CHECK_EQUAL(interner.GetNumberOfNames(), number_of_names + 1);
+    for (unsigned index = 0; index < ids.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(ids[index], ids[index % number_of_names]);
+        BOOST_CHECK(ids[index] > 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
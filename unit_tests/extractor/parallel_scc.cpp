@@ -0,0 +1,116 @@
+#include "extractor/parallel_scc.hpp"
+#include "extractor/tarjan_scc.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(parallel_scc)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+struct TestData
+{
+};
+using TestGraph = util::StaticGraph<TestData>;
+using TestInputEdge = TestGraph::InputEdge;
+
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 15;
+
+std::shared_ptr<const TestGraph> makeGraph(const unsigned number_of_nodes,
+                                           std::vector<TestInputEdge> edges)
+{
+    std::sort(edges.begin(), edges.end(), [](const TestInputEdge &lhs, const TestInputEdge &rhs)
+              {
+                  return std::tie(lhs.source, lhs.target) < std::tie(rhs.source, rhs.target);
+              });
+    return std::make_shared<const TestGraph>(number_of_nodes, edges);
+}
+
+BOOST_AUTO_TEST_CASE(small_graph)
+{
+    // 0 <-> 1 -> 2 <-> 3 -> 4, 5 -> 5
+    std::vector<TestInputEdge> edges = {
+        {0, 1}, {1, 0}, {1, 2}, {2, 3}, {3, 2}, {3, 4}, {5, 5},
+    };
+    ParallelSCC<TestGraph> scc(makeGraph(6, edges));
+    scc.run();
+
+    BOOST_CHECK_EQUAL(scc.get_number_of_components(), 4);
+    BOOST_CHECK_EQUAL(scc.get_size_one_count(), 2);
+
+    // numbered by smallest node id
+    const std::vector<unsigned> expected_ids = {0, 0, 1, 1, 2, 3};
+    for (const auto node : util::irange(0u, 6u))
+    {
+        BOOST_CHECK_EQUAL(scc.get_component_id(node), expected_ids[node]);
+    }
+    BOOST_CHECK_EQUAL(scc.get_component_size(0), 2);
+    BOOST_CHECK_EQUAL(scc.get_component_size(1), 2);
+    BOOST_CHECK_EQUAL(scc.get_component_size(2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(same_components_as_tarjan)
+{
+    std::mt19937 generator(RANDOM_SEED);
+
+    // sparse graphs with long chains, like road networks, and denser ones
+    for (const unsigned edges_per_node : {1u, 2u, 4u})
+    {
+        const unsigned number_of_nodes = 5000;
+        std::uniform_int_distribution<unsigned> node_distribution(0, number_of_nodes - 1);
+        std::uniform_int_distribution<unsigned> offset_distribution(1, 5);
+
+        std::vector<TestInputEdge> edges;
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            edges.emplace_back(node, (node + offset_distribution(generator)) % number_of_nodes);
+            for (const auto i : util::irange(1u, edges_per_node))
+            {
+                (void)i;
+                edges.emplace_back(node_distribution(generator), node_distribution(generator));
+            }
+        }
+        // cut the ring into pieces
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [](const TestInputEdge &edge)
+                                   {
+                                       return edge.source % 97 == 0;
+                                   }),
+                    edges.end());
+
+        const auto graph = makeGraph(number_of_nodes, edges);
+        TarjanSCC<TestGraph> tarjan(graph);
+        tarjan.run();
+        ParallelSCC<TestGraph> scc(graph);
+        scc.run();
+
+        BOOST_REQUIRE_EQUAL(scc.get_number_of_components(), tarjan.get_number_of_components());
+        BOOST_CHECK_EQUAL(scc.get_size_one_count(), tarjan.get_size_one_count());
+
+        // both numberings describe the same partition
+        std::vector<unsigned> tarjan_to_parallel(tarjan.get_number_of_components(),
+                                                 SPECIAL_NODEID);
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            const auto tarjan_id = tarjan.get_component_id(node);
+            const auto parallel_id = scc.get_component_id(node);
+            if (SPECIAL_NODEID == tarjan_to_parallel[tarjan_id])
+            {
+                tarjan_to_parallel[tarjan_id] = parallel_id;
+            }
+            BOOST_CHECK_EQUAL(tarjan_to_parallel[tarjan_id], parallel_id);
+            BOOST_CHECK_EQUAL(scc.get_component_size(parallel_id),
+                              tarjan.get_component_size(tarjan_id));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,54 @@
+#include "extractor/tag_filter.hpp"
+
+#include <osmium/builder/builder_helper.hpp>
+#include <osmium/memory/buffer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(tag_filter)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+BOOST_AUTO_TEST_CASE(inactive_filter_matches_everything)
+{
+    osmium::memory::Buffer buffer(1024);
+    const TagFilter filter;
+    BOOST_CHECK(!filter.IsActive());
+    BOOST_CHECK(filter.Matches(osmium::builder::build_tag_list(buffer, {})));
+    BOOST_CHECK(filter.Matches(osmium::builder::build_tag_list(buffer, {{"name", "Main"}})));
+
+    // a profile that declares no keys doesn't filter either
+    BOOST_CHECK(!TagFilter(std::vector<std::string>{}).IsActive());
+}
+
+BOOST_AUTO_TEST_CASE(matches_declared_keys_only)
+{
+    osmium::memory::Buffer buffer(1024);
+    const TagFilter filter({"highway", "barrier"});
+    BOOST_CHECK(filter.IsActive());
+
+    BOOST_CHECK(filter.Matches(osmium::builder::build_tag_list(buffer, {{"highway", "primary"}})));
+    BOOST_CHECK(filter.Matches(
+        osmium::builder::build_tag_list(buffer, {{"name", "Main"}, {"barrier", "gate"}})));
+
+    BOOST_CHECK(!filter.Matches(osmium::builder::build_tag_list(buffer, {})));
+    BOOST_CHECK(!filter.Matches(osmium::builder::build_tag_list(buffer, {{"name", "Main"}})));
+    // values and prefixes of declared keys don't count
+    BOOST_CHECK(!filter.Matches(osmium::builder::build_tag_list(buffer, {{"name", "highway"}})));
+    BOOST_CHECK(!filter.Matches(osmium::builder::build_tag_list(buffer, {{"highway:lanes", "2"}})));
+    BOOST_CHECK(!filter.Matches(osmium::builder::build_tag_list(buffer, {{"high", "yes"}})));
+}
+
+BOOST_AUTO_TEST_CASE(keys_are_sorted_and_unique)
+{
+    const TagFilter filter({"oneway", "highway", "oneway", "access"});
+    const std::vector<std::string> expected = {"access", "highway", "oneway"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(filter.GetKeys().begin(), filter.GetKeys().end(),
+                                  expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
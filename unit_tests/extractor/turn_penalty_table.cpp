@@ -0,0 +1,60 @@
+#include "extractor/turn_penalty_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+BOOST_AUTO_TEST_SUITE(turn_penalty_table)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// car profile with turn_penalty = 60 and turn_bias = 1.2, truncated like the lua call
+int CarTurnPenalty(const double angle)
+{
+    const double deviation = 180. - angle;
+    const double k = 60 / (90.0 * 90.0);
+    return static_cast<int>(deviation >= 0 ? deviation * deviation * k / 1.2
+                                           : deviation * deviation * k * 1.2);
+}
+}
+
+BOOST_AUTO_TEST_CASE(samples_are_exact)
+{
+    const TurnPenaltyTable table(CarTurnPenalty);
+
+    for (unsigned sample = 0; sample <= 360 * TurnPenaltyTable::RESOLUTION; ++sample)
+    {
+        // the same angle as the table sampled, and one with a different rounding error
+        const double angle = static_cast<double>(sample) / TurnPenaltyTable::RESOLUTION;
+        BOOST_CHECK_EQUAL(table.GetPenalty(angle), CarTurnPenalty(angle));
+        BOOST_CHECK_EQUAL(table.GetPenalty(sample * (1. / TurnPenaltyTable::RESOLUTION)),
+                          CarTurnPenalty(angle));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(penalties_between_samples_are_close)
+{
+    const TurnPenaltyTable table(CarTurnPenalty);
+
+    for (double angle = 0.013; angle <= 360; angle += 0.37)
+    {
+        BOOST_CHECK_LE(std::abs(table.GetPenalty(angle) - CarTurnPenalty(angle)), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(out_of_range_angles_are_clamped)
+{
+    const TurnPenaltyTable table([](const double angle)
+                                 {
+                                     return static_cast<int>(angle);
+                                 });
+
+    BOOST_CHECK_EQUAL(table.GetPenalty(-1.), 0);
+    BOOST_CHECK_EQUAL(table.GetPenalty(361.), 360);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include "storage/dataset_container.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(dataset_container)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+// Writes a container with a graph node list of 1000 entries and a timestamp
+boost::filesystem::path writeContainer(const std::uint64_t magic_number)
+{
+    DatasetContainerHeader header;
+    header.magic_number = magic_number;
+    header.version = DatasetContainer::VERSION;
+    header.fingerprint = util::FingerPrint::GetValid();
+    header.layout = SharedDataLayout();
+    header.layout.block_alignment = DatasetContainer::PAGE_SIZE;
+    header.layout.SetBlockSize<unsigned>(SharedDataLayout::GRAPH_NODE_LIST, 1000);
+    header.layout.SetBlockSize<char>(SharedDataLayout::TIMESTAMP, 4);
+
+    std::vector<char> data(header.layout.GetSizeOfLayout());
+    for (const auto block : util::irange(0, static_cast<int>(SharedDataLayout::NUM_BLOCKS)))
+    {
+        header.layout.GetBlockPtr<char, true>(data.data(),
+                                              static_cast<SharedDataLayout::BlockID>(block));
+    }
+    auto *nodes =
+        header.layout.GetBlockPtr<unsigned>(data.data(), SharedDataLayout::GRAPH_NODE_LIST);
+    std::iota(nodes, nodes + 1000, 0u);
+    std::copy_n("2016", 4,
+                header.layout.GetBlockPtr<char>(data.data(), SharedDataLayout::TIMESTAMP));
+    for (const auto block : util::irange(0, static_cast<int>(SharedDataLayout::NUM_BLOCKS)))
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(block);
+        header.block_checksums[bid] = DatasetContainer::ComputeChecksum(
+            header.layout.GetBlockPtr<char>(data.data(), bid), header.layout.GetBlockSize(bid));
+    }
+
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("%%%%-%%%%.dataset");
+    boost::filesystem::ofstream stream(path, std::ios::binary);
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const std::vector<char> padding(DatasetContainer::DATA_OFFSET - sizeof(header));
+    stream.write(padding.data(), padding.size());
+    stream.write(data.data(), data.size());
+    return path;
+}
+}
+
+BOOST_AUTO_TEST_CASE(blocks_are_page_aligned_and_valid)
+{
+    const auto path = writeContainer(DatasetContainer::MAGIC_NUMBER);
+    {
+        const DatasetContainer container(path);
+        const auto &layout = container.GetLayout();
+
+        const auto *nodes =
+            layout.GetBlockPtr<unsigned>(container.GetDataPtr(), SharedDataLayout::GRAPH_NODE_LIST);
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(nodes) % DatasetContainer::PAGE_SIZE,
+                          0);
+        BOOST_CHECK_EQUAL(nodes[999], 999);
+
+        for (const auto block : util::irange(0, static_cast<int>(SharedDataLayout::NUM_BLOCKS)))
+        {
+            BOOST_CHECK(container.IsBlockValid(static_cast<SharedDataLayout::BlockID>(block)));
+        }
+    }
+
+    // flip a byte of the graph nodes
+    const auto layout = DatasetContainer(path).GetLayout();
+    {
+        boost::filesystem::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(DatasetContainer::DATA_OFFSET +
+                     layout.GetBlockOffset(SharedDataLayout::GRAPH_NODE_LIST) + 10);
+        stream.put(42);
+    }
+    const DatasetContainer container(path);
+    BOOST_CHECK(!container.IsBlockValid(SharedDataLayout::GRAPH_NODE_LIST));
+    BOOST_CHECK(container.IsBlockValid(SharedDataLayout::TIMESTAMP));
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_other_files)
+{
+    const auto path = writeContainer(0);
+    BOOST_CHECK_THROW(DatasetContainer container(path), util::exception);
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
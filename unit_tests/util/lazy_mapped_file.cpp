@@ -0,0 +1,59 @@
+#include "util/lazy_mapped_file.hpp"
+#include "util/process_memory.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(lazy_mapped_file)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(views_on_file)
+{
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("lazy-mapped-file-%%%%-%%%%.bin");
+    {
+        // a count followed by the entries, like the files of the datafacade
+        const std::vector<unsigned> entries = {7, 11, 13};
+        const unsigned number_of_entries = entries.size();
+        boost::filesystem::ofstream stream(path, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(&number_of_entries), sizeof(unsigned));
+        stream.write(reinterpret_cast<const char *>(entries.data()),
+                     entries.size() * sizeof(unsigned));
+    }
+
+    {
+        const LazyMappedFile file(path);
+        // nothing is mapped before the first access
+        BOOST_CHECK_EQUAL(file.GetResidentSize(), 0);
+        BOOST_CHECK(file.GetView<unsigned>(sizeof(unsigned), 0).empty());
+        BOOST_CHECK_EQUAL(file.GetResidentSize(), 0);
+
+        const auto view = file.GetView<unsigned>(sizeof(unsigned), 3);
+        BOOST_REQUIRE_EQUAL(view.size(), 3);
+        BOOST_CHECK_EQUAL(view[0], 7);
+        BOOST_CHECK_EQUAL(view[2], 13);
+        BOOST_CHECK_LE(file.GetResidentSize(), 4 * sizeof(unsigned));
+    }
+    boost::filesystem::remove(path);
+
+    const LazyMappedFile missing_file(path);
+    BOOST_CHECK_THROW(missing_file.GetData(), exception);
+}
+
+BOOST_AUTO_TEST_CASE(resident_size)
+{
+    std::vector<char> memory(1024 * 1024, 1);
+    BOOST_CHECK_LE(getResidentSize(memory.data(), memory.size()), memory.size());
+    BOOST_CHECK_EQUAL(getResidentSize(memory.data(), 0), 0);
+#ifdef __linux__
+    // the vector was just written, so its pages are in memory
+    BOOST_CHECK_EQUAL(getResidentSize(memory.data(), memory.size()), memory.size());
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+#include "util/numa.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(numa_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list)
+{
+    const std::vector<unsigned> ranges = {0, 1, 2, 3, 8, 10, 11};
+    const auto parsed = NumaTopology::ParseCPUList("0-3,8,10-11");
+    BOOST_CHECK_EQUAL_COLLECTIONS(parsed.begin(), parsed.end(), ranges.begin(), ranges.end());
+
+    // nodes without CPUs have an empty list
+    BOOST_CHECK(NumaTopology::ParseCPUList("").empty());
+}
+
+BOOST_AUTO_TEST_CASE(topology_has_a_node)
+{
+    const NumaTopology topology;
+    BOOST_CHECK_GE(topology.NumberOfNodes(), 1u);
+    BOOST_CHECK_LT(topology.CurrentNode(), topology.NumberOfNodes());
+}
+
+BOOST_AUTO_TEST_CASE(sparse_node_ids)
+{
+    // nodes 0 and 2 are online, node 3 is memory-only
+    const auto node_root = boost::filesystem::temp_directory_path() /
+                           boost::filesystem::unique_path("numa-%%%%-%%%%");
+    const auto write_file = [&node_root](const std::string &path, const std::string &content) {
+        boost::filesystem::create_directories((node_root / path).parent_path());
+        boost::filesystem::ofstream stream(node_root / path);
+        stream << content << std::endl;
+    };
+    write_file("online", "0,2-3");
+    write_file("node0/cpulist", "0-1");
+    write_file("node2/cpulist", "2-3");
+    write_file("node3/cpulist", "");
+
+    const NumaTopology topology(node_root);
+    boost::filesystem::remove_all(node_root);
+
+    BOOST_CHECK_EQUAL(topology.NumberOfNodes(), 3u);
+    const std::vector<unsigned> cpu_to_node = {0, 0, 1, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(topology.CPUToNode().begin(), topology.CPUToNode().end(),
+                                  cpu_to_node.begin(), cpu_to_node.end());
+    BOOST_CHECK(!topology.BindCurrentThread(2));
+}
+
+BOOST_AUTO_TEST_CASE(missing_topology_has_a_node)
+{
+    const NumaTopology topology(boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path("numa-%%%%-%%%%"));
+    BOOST_CHECK_EQUAL(topology.NumberOfNodes(), 1u);
+    BOOST_CHECK(topology.CPUToNode().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
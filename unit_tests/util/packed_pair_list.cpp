@@ -0,0 +1,99 @@
+#include "util/packed_pair_list.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(packed_pair_list)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::vector<char> Pack(const std::vector<PackedPairList::Pair> &pairs)
+{
+    PackedPairListBuilder builder;
+    for (const auto &pair : pairs)
+    {
+        builder.Add(pair.first, pair.second);
+    }
+    // the list has to work on unaligned buffers
+    std::vector<char> buffer(builder.GetBufferSize() + 1);
+    builder.Write(buffer.data() + 1);
+    return buffer;
+}
+}
+
+BOOST_AUTO_TEST_CASE(empty_list)
+{
+    const auto buffer = Pack({});
+    const PackedPairList list(buffer.data() + 1);
+    BOOST_CHECK(list.empty());
+    BOOST_CHECK_EQUAL(list.size(), 0);
+    list.ForEach(0, 0, [](const PackedPairList::Pair &) { BOOST_ERROR("no pairs expected"); });
+}
+
+BOOST_AUTO_TEST_CASE(random_access)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> step(-1000, 1000);
+    std::uniform_int_distribution<std::int32_t> any(std::numeric_limits<std::int32_t>::min(),
+                                                    std::numeric_limits<std::int32_t>::max());
+
+    std::vector<PackedPairList::Pair> pairs = {
+        {0, 0},
+        {std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max()},
+        {std::numeric_limits<std::int32_t>::max(), std::numeric_limits<std::int32_t>::min()},
+        {-1, 1}};
+    for (int i = 0; i < 1000; ++i)
+    {
+        // mostly small steps like along a road, with some jumps
+        if (i % 50 == 0)
+        {
+            pairs.emplace_back(any(generator), any(generator));
+        }
+        else
+        {
+            pairs.emplace_back(pairs.back().first + step(generator),
+                               pairs.back().second + step(generator));
+        }
+    }
+
+    const auto buffer = Pack(pairs);
+    BOOST_CHECK_LT(buffer.size(), pairs.size() * sizeof(PackedPairList::Pair));
+
+    const PackedPairList list(buffer.data() + 1);
+    BOOST_REQUIRE_EQUAL(list.size(), pairs.size());
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+    {
+        BOOST_CHECK(list.at(i) == pairs[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ranges_across_blocks)
+{
+    std::vector<PackedPairList::Pair> pairs;
+    for (std::int32_t i = 0; i < 100; ++i)
+    {
+        pairs.emplace_back(i * 7 - 300, 1000 - i * i);
+    }
+    const auto buffer = Pack(pairs);
+    const PackedPairList list(buffer.data() + 1);
+
+    const std::vector<std::pair<std::size_t, std::size_t>> ranges = {
+        {0, 100}, {3, 5}, {15, 17}, {16, 32}, {31, 70}, {99, 100}, {40, 40}};
+    for (const auto &range : ranges)
+    {
+        std::vector<PackedPairList::Pair> decoded;
+        list.ForEach(range.first, range.second,
+                     [&decoded](const PackedPairList::Pair &pair) { decoded.push_back(pair); });
+        BOOST_CHECK(decoded == std::vector<PackedPairList::Pair>(pairs.begin() + range.first,
+                                                                 pairs.begin() + range.second));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()